@@ -51,15 +51,15 @@ int allocation_count()
 }
 int allocation_size(int index)
 {
-	return (int)wma_allocator.slots[index].size;
+	return (int)wma__get_slot(&wma_allocator, index).size;
 }
 int allocation_status(int index)
 {
-	return wma_allocator.slots[index].allocated;
+	return wma__get_slot(&wma_allocator, index).allocated;
 }
 int allocation_offset(int index)
 {
-	return wma_allocator.slots[index].offset;
+	return wma__get_slot(&wma_allocator, index).offset;
 }
 #else
 int heap_size() { return 0; }
@@ -80,8 +80,17 @@ void grow_##TYPE(Array_ ## TYPE* array, size_t amount) \
 { \
 	if (array->cap >= array->len + amount) \
 		return; \
-	array->cap = (array->len + amount + 1) * 3 / 2; \
-	array->data = realloc(array->data, sizeof(TYPE) * array->cap); \
+	size_t cap = (array->len + amount + 1) * 3 / 2; \
+	if (!array->data || !wma_try_expand(array->data, sizeof(TYPE) * cap)) { \
+		/* Not realloc, that would try to expand in place again */ \
+		TYPE* data = malloc(sizeof(TYPE) * cap); \
+		for (size_t i = 0; i < array->len; ++i) \
+			data[i] = array->data[i]; \
+		if (array->data) \
+			free(array->data); \
+		array->data = data; \
+	} \
+	array->cap = wma_usable_size(array->data) / sizeof(TYPE); \
 } \
 void push_##TYPE(Array_ ## TYPE* array, TYPE value) \
 { \
@@ -0,0 +1,13 @@
+:: Compile and run natively with clang, 64-bit and 32-bit
+clang -Wall -Wextra -std=gnu11 -O1 -o host.exe host.c && host.exe
+clang -Wall -Wextra -std=gnu11 -O1 -m32 -o host32.exe host.c && host32.exe
+
+:: SIMD slot search: SSE2 (64-bit and 32-bit), then SSE4.2
+clang -Wall -Wextra -std=gnu11 -O1 -DWMA_FAST_SIMD -o host_simd.exe host.c && host_simd.exe
+clang -Wall -Wextra -std=gnu11 -O1 -DWMA_FAST_SIMD -m32 -o host_simd32.exe host.c && host_simd32.exe
+clang -Wall -Wextra -std=gnu11 -O1 -DWMA_FAST_SIMD -msse4.2 -o host_sse42.exe host.c && host_sse42.exe
+
+:: Generic nursery, alone and with the SIMD slot search
+clang -Wall -Wextra -std=gnu11 -O1 -DWMA_GENERIC_NURSERY -o host_nursery.exe host.c && host_nursery.exe
+clang -Wall -Wextra -std=gnu11 -O1 -DWMA_GENERIC_NURSERY -m32 -o host_nursery32.exe host.c && host_nursery32.exe
+clang -Wall -Wextra -std=gnu11 -O1 -DWMA_GENERIC_NURSERY -DWMA_FAST_SIMD -o host_all.exe host.c && host_all.exe
@@ -0,0 +1,362 @@
+// Native test of the allocators on the host backend (WMA_HOST).
+// Build as 64-bit to cover sizes past 4GB, and with -m32 to check the
+// wasm32 layout, see build.bat. Prints "ok" and returns 0 on success.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void test_panic(const char* topic, const char* what, int line)
+{
+	printf("%s: %s (wma.h:%d)\n", topic, what, line);
+	exit(1);
+}
+#define wma__panic(TOPIC,WHAT,LINE) test_panic(TOPIC, WHAT, LINE)
+
+#define WMA_HOST
+#define WMA_IMPLEMENTATION
+#include "../wma.h"
+
+#define CHECK(EXPR) \
+	do { \
+		if (!(EXPR)) { \
+			printf("FAILED line %d: %s\n", __LINE__, #EXPR); \
+			return 1; \
+		} \
+	} while (0)
+
+// Metadata has to stay as compact as before on wasm32
+#if defined(WMA_64BIT)
+_Static_assert(sizeof(Wma_Slot)   == 16, "Wma_Slot is two words");
+_Static_assert(sizeof(Wma_Region) == 24, "Wma_Region is three words");
+#else
+_Static_assert(sizeof(Wma_Slot)   == 8,  "Wma_Slot is two words");
+_Static_assert(sizeof(Wma_Region) == 12, "Wma_Region is three words");
+#endif
+
+static int test_buckets(void)
+{
+	int last = 0;
+	for (size_t size = 8; size <= (size_t)WMA_PAGE_SIZE * WMA_HOST_MAX_PAGES; size += size / 7 + 1)
+	{
+		int bucket = wma__bucket_index(size);
+		CHECK(bucket >= last);
+		CHECK(bucket < WMA__BUCKET_COUNT);
+		last = bucket;
+	}
+#if defined(WMA_64BIT)
+	CHECK(wma__bucket_index((size_t)5 << 30) > wma__bucket_index((size_t)3 << 30));
+#endif
+	return 0;
+}
+
+static int test_heap(Wma_Heap_Kind Kind, size_t Size)
+{
+	Wma_Heap heap;
+	wma_heap_create(&heap, Kind, 1);
+
+	unsigned char* small = wma_heap_alloc(&heap, 96);
+	unsigned char* a = wma_heap_alloc(&heap, Size);
+	unsigned char* b = wma_heap_alloc(&heap, Size);
+	CHECK(small && a && b);
+	memset(small, 1, 96);
+	a[0] = 2; a[Size - 1] = 3;
+	b[0] = 4; b[Size - 1] = 5;
+
+	CHECK(wma_heap_usable_size(&heap, a) >= Size);
+	CHECK(wma_heap_usable_size(&heap, b) >= Size);
+	CHECK(a[0] == 2 && a[Size - 1] == 3);
+	CHECK(b[0] == 4 && b[Size - 1] == 5);
+	for (int i = 0; i < 96; ++i) CHECK(small[i] == 1);
+
+	wma_heap_destroy(&heap);
+	return 0;
+}
+
+static uint32_t test_random(void)
+{
+	static uint32_t state = 2463534242u;
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+// Every byte of a block holds its index, so any overlap shows up
+static int test_blocks_intact(unsigned char** Blocks, size_t* Sizes, int Count)
+{
+	for (int i = 0; i < Count; ++i)
+		for (size_t k = 0; Blocks[i] && k < Sizes[i]; ++k) CHECK(Blocks[i][k] == (unsigned char)i);
+	return 0;
+}
+
+// Random alloc, free, realloc and try_expand traffic, then a reset and the same again
+static int test_churn(Wma_Heap_Kind Kind)
+{
+	enum { COUNT = 500 };
+	unsigned char* blocks[COUNT];
+	size_t sizes[COUNT];
+
+	Wma_Heap heap;
+	wma_heap_create(&heap, Kind, 1);
+
+	for (int round = 0; round < 2; ++round) {
+		memset(blocks, 0, sizeof(blocks));
+		for (int step = 0; step < 20000; ++step) {
+			int i = test_random() % COUNT;
+			size_t size = 1 + test_random() % 4000;
+
+			if (blocks[i] == NULL) {
+				blocks[i] = wma_heap_alloc(&heap, size);
+				CHECK(blocks[i] != NULL);
+				memset(blocks[i], i, size);
+				sizes[i] = size;
+				continue;
+			}
+			switch (test_random() % 3) {
+			case 0:
+				wma_heap_free(&heap, blocks[i]);
+				blocks[i] = NULL;
+				break;
+			case 1:
+				blocks[i] = wma_heap_realloc(&heap, blocks[i], size);
+				CHECK(blocks[i] != NULL);
+				if (size > sizes[i]) memset(blocks[i] + sizes[i], i, size - sizes[i]);
+				sizes[i] = size;
+				break;
+			case 2:
+				if (wma_heap_try_expand(&heap, blocks[i], sizes[i] + size)) {
+					CHECK(wma_heap_usable_size(&heap, blocks[i]) >= sizes[i] + size);
+					memset(blocks[i] + sizes[i], i, size);
+					sizes[i] += size;
+				}
+				break;
+			}
+		}
+		if (test_blocks_intact(blocks, sizes, COUNT)) return 1;
+		wma_heap_reset(&heap);
+	}
+
+	wma_heap_destroy(&heap);
+	return 0;
+}
+
+// Holes of growing sizes every third slot, so the search ends at every
+// position within a SIMD vector as well as in the scalar tail
+static int test_free_slots(void)
+{
+	enum { COUNT = 64 };
+	unsigned char* blocks[COUNT];
+
+	Wma_Heap heap;
+	wma_heap_create(&heap, WMA_HEAP_FAST, 1);
+	Wma_Fast_Allocator* allocator = &heap.fast;
+
+	for (int i = 0; i < COUNT; ++i)
+		blocks[i] = wma_heap_alloc(&heap, 16 + i * 8);
+	for (int i = 0; i < COUNT; i += 3)
+		wma_heap_free(&heap, blocks[i]);
+
+	// Same answer as looking at one slot at a time
+	for (size_t size = 8; size <= 16 + COUNT * 8; size += 8) {
+		uint32_t expected = allocator->slot_count;
+		for (uint32_t k = allocator->first_free; k < allocator->slot_count; ++k) {
+			Wma_Slot slot = wma__get_slot(allocator, k);
+			if (!slot.allocated && slot.size >= size) {
+				expected = k;
+				break;
+			}
+		}
+		CHECK(wma__fast_find_free(allocator, size) == expected);
+	}
+
+	// Largest first, every allocation fits only the hole it came from
+	uint32_t slot_count = allocator->slot_count;
+	for (int i = (COUNT - 1) / 3 * 3; i >= 0; i -= 3)
+		CHECK(wma_heap_alloc(&heap, 16 + i * 8) == blocks[i]);
+	CHECK(allocator->slot_count <= slot_count + 1);
+
+	wma_heap_destroy(&heap);
+	return 0;
+}
+
+static int test_snapshot(Wma_Heap_Kind Kind)
+{
+	Wma_Heap heap;
+	wma_heap_create(&heap, Kind, 1);
+	int* numbers[64];
+	for (int i = 0; i < 64; ++i) {
+		numbers[i] = wma_heap_alloc(&heap, (i + 1) * sizeof(int));
+		for (int k = 0; k <= i; ++k) numbers[i][k] = i;
+	}
+
+	size_t size = wma_snapshot(&heap, NULL, 0);
+	void* image = malloc(size);
+	CHECK(wma_snapshot(&heap, image, size) == size);
+	CHECK(wma_restore(&heap, image, size - 1) == 0);
+
+	wma_heap_destroy(&heap);
+	CHECK(wma_restore(&heap, image, size));
+	for (int i = 0; i < 64; ++i)
+		for (int k = 0; k <= i; ++k) CHECK(numbers[i][k] == i);
+
+	wma_heap_destroy(&heap);
+	free(image);
+	return 0;
+}
+
+#if defined(WMA_GENERIC_NURSERY)
+static uint32_t test_generic_pages(Wma_Generic_Allocator* Allocator)
+{
+	uint32_t pages = Allocator->base_pages;
+	for (Wma_Page_Chunk* chunk = Allocator->chunks; chunk; chunk = chunk->next)
+		pages += chunk->page_count;
+	return pages;
+}
+
+static Wma_Nursery_Chunk* test_chunk_of(void* Ptr)
+{
+	return (void*)((Wma_Region*)Ptr - 1)->next;
+}
+
+static int test_nursery(void)
+{
+	// Blocks for the temporaries, or for filling three chunks
+	enum { COUNT = 1000, KEPT = 200 };
+	unsigned char* blocks[COUNT + 3 * WMA_NURSERY_CHUNK_PAGES * WMA_PAGE_SIZE / WMA_NURSERY_MAX_SIZE];
+	unsigned char* kept[KEPT];
+
+	Wma_Heap heap;
+	wma_heap_create(&heap, WMA_HEAP_GENERIC, 1);
+	Wma_Generic_Allocator* allocator = &heap.generic;
+
+	// The current chunk starts over once everything in it is freed
+	for (int i = 0; i < 8; ++i)
+		blocks[i] = wma_heap_alloc(&heap, 24);
+	Wma_Nursery_Chunk* first = allocator->nursery;
+	for (int i = 0; i < 8; ++i)
+		wma_heap_free(&heap, blocks[i]);
+	CHECK(allocator->nursery == first && first->live == 0);
+	CHECK(wma_heap_alloc(&heap, 24) == blocks[0]);
+	wma_heap_free(&heap, blocks[0]);
+
+	// Only the last allocation of the current chunk grows in place,
+	// and not past the nursery size limit
+	unsigned char* a = wma_heap_alloc(&heap, 16);
+	unsigned char* b = wma_heap_alloc(&heap, 16);
+	CHECK(!wma_heap_try_expand(&heap, a, 64));
+	CHECK(wma_heap_try_expand(&heap, b, WMA_NURSERY_MAX_SIZE));
+	CHECK(wma_heap_usable_size(&heap, b) >= WMA_NURSERY_MAX_SIZE);
+	CHECK(!wma_heap_try_expand(&heap, b, WMA_NURSERY_MAX_SIZE + 1));
+
+	// Realloc past the limit moves the allocation out of the nursery
+	memset(b, 7, WMA_NURSERY_MAX_SIZE);
+	unsigned char* c = wma_heap_realloc(&heap, b, WMA_NURSERY_MAX_SIZE * 2);
+	CHECK(c != b && !wma__is_nursery((Wma_Region*)c - 1));
+	for (int k = 0; k < WMA_NURSERY_MAX_SIZE; ++k) CHECK(c[k] == 7);
+	CHECK(first->live == 1);
+	wma_heap_free(&heap, a);
+	wma_heap_free(&heap, c);
+
+	// Fill two chunks and start a third. Emptying the first one makes it
+	// the spare, emptying the second gives it back to the heap.
+	Wma_Nursery_Chunk* chunks[3] = { allocator->nursery };
+	int count = 0;
+	for (int k = 1; k < 3; ++k) {
+		while (allocator->nursery == chunks[k - 1])
+			blocks[count++] = wma_heap_alloc(&heap, WMA_NURSERY_MAX_SIZE);
+		chunks[k] = allocator->nursery;
+	}
+	for (int k = 0; k < 2; ++k)
+		for (int i = 0; i < count; ++i)
+			if (blocks[i] && test_chunk_of(blocks[i]) == chunks[k]) {
+				wma_heap_free(&heap, blocks[i]);
+				blocks[i] = NULL;
+			}
+	CHECK(allocator->nursery_spare == chunks[0]);
+	CHECK(((Wma_Region*)chunks[1] - 1)->used == 0);
+
+	// The spare is the next chunk
+	while (allocator->nursery == chunks[2])
+		blocks[count++] = wma_heap_alloc(&heap, WMA_NURSERY_MAX_SIZE);
+	CHECK(allocator->nursery == chunks[0] && allocator->nursery_spare == NULL);
+	for (int i = 0; i < count; ++i)
+		if (blocks[i]) wma_heap_free(&heap, blocks[i]);
+
+	// Realloc where the new allocation retires the chunk of the old one
+	unsigned char* old = wma_heap_alloc(&heap, 16);
+	memset(old, 9, 16);
+	Wma_Nursery_Chunk* chunk = allocator->nursery;
+	count = 0;
+	while (allocator->nursery == chunk)
+		blocks[count++] = wma_heap_alloc(&heap, WMA_NURSERY_MAX_SIZE);
+	for (int i = 0; i < count; ++i)
+		wma_heap_free(&heap, blocks[i]);
+	for (int i = 0; i < WMA_NURSERY_AGE; ++i)
+		wma_heap_free(&heap, wma_heap_alloc(&heap, 8));
+	count = 0;
+	while (allocator->nursery->top + sizeof(Wma_Region) + wma__nursery_size(WMA_NURSERY_MAX_SIZE) <= allocator->nursery->end)
+		blocks[count++] = wma_heap_alloc(&heap, WMA_NURSERY_MAX_SIZE / 2);
+	unsigned char* moved = wma_heap_realloc(&heap, old, WMA_NURSERY_MAX_SIZE);
+	CHECK(!wma__is_nursery((Wma_Region*)old - 1) && ((Wma_Region*)old - 1)->used == 0);
+	for (int k = 0; k < 16; ++k) CHECK(moved[k] == 9);
+	wma_heap_free(&heap, moved);
+	for (int i = 0; i < count; ++i)
+		wma_heap_free(&heap, blocks[i]);
+
+	// One of every COUNT temporaries survives. Retired chunks give
+	// everything else back to the heap, so survivors don't pin pages.
+	uint32_t pages = test_generic_pages(allocator);
+	for (int round = 0; round < KEPT; ++round) {
+		for (int i = 0; i < COUNT; ++i)
+			blocks[i] = wma_heap_alloc(&heap, 48);
+		kept[round] = blocks[0];
+		memset(kept[round], round, 48);
+		for (int i = 1; i < COUNT; ++i)
+			wma_heap_free(&heap, blocks[i]);
+	}
+	CHECK(test_generic_pages(allocator) <= pages + 2);
+	CHECK(!wma__is_nursery((Wma_Region*)kept[0] - 1));
+
+	// Snapshot with survivors in retired, full and current chunks
+	size_t size = wma_snapshot(&heap, NULL, 0);
+	void* image = malloc(size);
+	CHECK(wma_snapshot(&heap, image, size) == size);
+	for (int round = 0; round < KEPT; ++round)
+		memset(kept[round], 0, 48);
+	wma_heap_destroy(&heap);
+	CHECK(wma_restore(&heap, image, size));
+	for (int round = 0; round < KEPT; ++round)
+		for (int k = 0; k < 48; ++k) CHECK(kept[round][k] == (unsigned char)round);
+	for (int round = 0; round < KEPT; ++round)
+		wma_heap_free(&heap, kept[round]);
+	for (int i = 0; i < COUNT; ++i)
+		blocks[i] = wma_heap_alloc(&heap, 1 + i % WMA_NURSERY_MAX_SIZE);
+	CHECK(test_generic_pages(allocator) <= pages + 2);
+
+	wma_heap_destroy(&heap);
+	free(image);
+	return 0;
+}
+#endif
+
+int main(void)
+{
+#if defined(WMA_64BIT)
+	size_t big = (size_t)5 << 29; // two of these go past 4GB
+#else
+	size_t big = (size_t)1 << 28;
+#endif
+	if (test_buckets())                       return 1;
+	if (test_heap(WMA_HEAP_FAST, big))        return 1;
+	if (test_heap(WMA_HEAP_GENERIC, big))     return 1;
+	if (test_free_slots())                    return 1;
+	if (test_churn(WMA_HEAP_FAST))            return 1;
+	if (test_churn(WMA_HEAP_GENERIC))         return 1;
+	if (test_snapshot(WMA_HEAP_FAST))         return 1;
+	if (test_snapshot(WMA_HEAP_GENERIC))      return 1;
+#if defined(WMA_GENERIC_NURSERY)
+	if (test_nursery())                       return 1;
+#endif
+	printf("ok\n");
+	return 0;
+}
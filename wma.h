@@ -1,5 +1,5 @@
 // 
-//    WASM Memory Allocator -- version 1.1.0
+//    WASM Memory Allocator -- version 1.2.0
 // --------------------------------------------
 // a general purpose memory allocator for WASM
 //
@@ -14,6 +14,19 @@
 //       - wma_alloc   <=> C malloc
 //       - wma_realloc <=> C realloc
 //       - wma_free    <=> C free
+//       - wma_usable_size(Ptr)       -- Bytes actually available at `Ptr`
+//       - wma_try_expand(Ptr, Size)  -- Grow in place, never moves memory
+//                                       (returns 0 when it cannot)
+//
+//     HEAPS:
+//       Independent heap instances, each wrapping its own fast or
+//       generic allocator. Resetting or destroying a heap releases
+//       every allocation at once and hands its pages back for reuse.
+//       - wma_heap_create / wma_heap_reset / wma_heap_destroy
+//       - wma_heap_alloc / wma_heap_realloc / wma_heap_free
+//       - wma_heap_usable_size / wma_heap_try_expand
+//       - wma_snapshot / wma_restore -- Save a heap, and load it back
+//                                       in a fresh instance
 //
 #ifndef WMA_H
 #define WMA_H
@@ -24,13 +37,23 @@
 #define WMA_DEF extern
 #endif
 
-#define WMA_PAGE_SIZE 65536             // ~ Fixed page size for WASM 
-#define WMA_INVALID ((void*)0xFFFFFFFF) // ~ Pointer that will always be invalid
+// ~ Addresses and sizes are as wide as a pointer, so 32-bit for wasm32
+//   and 64-bit for wasm64 (memory64) or a 64-bit host
+#if UINTPTR_MAX > 0xFFFFFFFF
+#define WMA_64BIT 1
+typedef uint64_t Wma_Word;
+#define WMA__SIZE_BITS 63
+#else
+typedef uint32_t Wma_Word;
+#define WMA__SIZE_BITS 31
+#endif
+
+#define WMA_PAGE_SIZE ((Wma_Word)65536)  // ~ Fixed page size for WASM 
+#define WMA_INVALID ((void*)~(Wma_Word)0) // ~ Pointer that will always be invalid
 
 // ~ Set which allocator to use as the global allocator
 // fast     -- Simple allocator with a fixed number of allocations.
 //          -- Allocations may be of any size.
-//          -- ! Does not work with external use of `memory_grow`.
 // generic  -- Default allocator, unlimited allocations of any size.
 #ifndef WMA_ALLOCATOR
 #define WMA_ALLOCATOR generic
@@ -49,16 +72,44 @@
 #define WMA_FAST_MAX_ALLOCATIONS 65536
 #endif
 
+// ~ Define WMA_GENERIC_NURSERY to bump allocate small allocations of the
+//   generic allocator from their own chunks. A chunk is reused once all of
+//   its allocations are freed, chunks that still hold some after
+//   WMA_NURSERY_AGE more small allocations are retired to the heap, which
+//   reuses their dead space right away.
+#ifndef WMA_NURSERY_MAX_SIZE
+#define WMA_NURSERY_MAX_SIZE 256   // Largest allocation that goes to the nursery
+#endif
+#ifndef WMA_NURSERY_AGE
+#define WMA_NURSERY_AGE 1024       // Counted in nursery allocations
+#endif
+#ifndef WMA_NURSERY_CHUNK_PAGES
+#define WMA_NURSERY_CHUNK_PAGES 1
+#endif
+
+// ~ Define WMA_HOST to run outside of WASM, address space is reserved up
+//   front (WMA_HOST_MAX_PAGES) and grown into like WASM memory.
+//   Or define wma__memory_grow(PAGES) and wma__memory_size() yourself.
+
+// ~ Define WMA_FAST_SIMD to keep the fast allocator's slots as separate
+//   offset and size arrays, so free slots are searched four at a time
+//   (two at a time on 64-bit).
+//   WASM needs `-msimd128`, otherwise SSE/NEON or plain C is used.
+
 #define WMA__FN(A,B,C) A ## B ## C
 #define wma__realloc(A,Ptr,Size) WMA__FN(wma_, A, _realloc)(&wma_global_allocator.A, Ptr, Size)
 #define wma__alloc(A,Size)       WMA__FN(wma_, A, _alloc  )(&wma_global_allocator.A, Size) 
 #define wma__free(A,Ptr)         WMA__FN(wma_, A, _free   )(&wma_global_allocator.A, Ptr)
+#define wma__usable_size(A,Ptr)     WMA__FN(wma_, A, _usable_size)(&wma_global_allocator.A, Ptr)
+#define wma__try_expand(A,Ptr,Size) WMA__FN(wma_, A, _try_expand )(&wma_global_allocator.A, Ptr, Size)
 
 // ~ Access the allocator, and each of it's corresponding functions
 #define wma_allocator         (wma_global_allocator.WMA_ALLOCATOR)
 #define wma_realloc(Ptr,Size) wma__realloc(WMA_ALLOCATOR, Ptr, Size)
 #define wma_alloc(Size)       wma__alloc(WMA_ALLOCATOR, Size) 
 #define wma_free(Ptr)         wma__free(WMA_ALLOCATOR, Ptr)
+#define wma_usable_size(Ptr)     wma__usable_size(WMA_ALLOCATOR, Ptr)
+#define wma_try_expand(Ptr,Size) wma__try_expand(WMA_ALLOCATOR, Ptr, Size)
 
 typedef struct {
 	const char* file;
@@ -68,21 +119,34 @@ typedef struct {
 } Wma_Metadata;
 
 typedef struct {
-	uint32_t offset; // Offset relative to `heap_start`
-	uint32_t allocated:1;
-	uint32_t size:31;
+	Wma_Word offset; // Offset relative to `heap_start`
+	Wma_Word allocated:1;
+	Wma_Word size:WMA__SIZE_BITS;
 } Wma_Slot;
 
+// Header at the start of every range of pages taken from the page pool
+typedef struct Wma_Page_Chunk {
+	struct Wma_Page_Chunk* next;
+	uint32_t page_count;
+} Wma_Page_Chunk;
+
 typedef struct {
-	uint32_t      start;          // Start of total heap memory
-	uint32_t      heap_start;     // Start of memory that can be allocated
-	uint32_t      total_size;     // Total size of heap including overhead
-	uint32_t      available_size; // Total amount of memory that can be allocated (able to grow)
-	uint32_t      slot_capacity;  // Maximum number of slots
+	Wma_Word      start;          // Start of bookkeeping memory (the slot table)
+	Wma_Word      heap_start;     // Start of memory that can be allocated
+	Wma_Word      total_size;     // Total size of heap including overhead
+	Wma_Word      available_size; // Span of memory covered by slots (able to grow)
+	uint32_t      slot_capacity;  // Number of slots the table can hold right now
+	uint32_t      slot_limit;     // Maximum number of slots, the table grows up to this
 	uint32_t      slot_count;     // Current number of slots
+#if defined(WMA_FAST_SIMD)
+	Wma_Word*     offsets;        // Slot offsets, relative to `heap_start`
+	Wma_Word*     sizes;          // Slot sizes, top bit is set when allocated
+#else
 	Wma_Slot*     slots;
+#endif
 	uint32_t      first_free;     // Index of first free slot
-	uint32_t      allocated;      // Total size of allocated memory
+	Wma_Word      allocated;      // Total size of allocated memory
+	Wma_Page_Chunk* chunks;       // Pages owned by this allocator, newest first
 #ifdef WMA_TRACK_ALLOCATIONS
 	Wma_Metadata* metadata;       // Mirror of slots, giving extra allocation info
 	Wma_Metadata  next_metadata;  // The metadata of the next allocation
@@ -90,15 +154,45 @@ typedef struct {
 } Wma_Fast_Allocator;
 
 typedef struct Wma_Region {
-	uint32_t size:31;
-	uint32_t used:1;
+	Wma_Word size:WMA__SIZE_BITS;
+	Wma_Word used:1;
 	struct Wma_Region* prev;
 	struct Wma_Region* next;
 } Wma_Region;
 
+// Number of size classes, 64-bit builds need more to cover larger sizes
+#if defined(WMA_64BIT)
+#define WMA__BUCKET_COUNT 108
+#else
+#define WMA__BUCKET_COUNT 64
+#endif
+
+#if defined(WMA_GENERIC_NURSERY)
+// Sits at the start of a used region of the heap
+typedef struct Wma_Nursery_Chunk {
+	struct Wma_Nursery_Chunk* next;    // Next in the full list
+	struct Wma_Nursery_Chunk* prev;    // Previous in the full list
+	Wma_Word                  top;     // Next free byte
+	Wma_Word                  end;     // End of the region holding the chunk
+	uint32_t                  live;    // Number of allocations not freed yet
+	uint32_t                  full_at; // Nursery clock when it stopped being allocated from
+} Wma_Nursery_Chunk;
+#endif
+
 typedef struct {
-	Wma_Region* heads[64];
-	Wma_Region* tails[64];
+	Wma_Region* heads[WMA__BUCKET_COUNT];
+	Wma_Region* tails[WMA__BUCKET_COUNT];
+	Wma_Page_Chunk* chunks;       // Pages taken from the page pool, newest first
+	Wma_Word        base;         // Start of pages reserved up front (kept on reset)
+	uint32_t        base_pages;   // Number of reserved pages
+	uint32_t        base_used;    // Number of reserved pages handed out to regions
+#if defined(WMA_GENERIC_NURSERY)
+	Wma_Nursery_Chunk* nursery;         // Nursery chunk being allocated from
+	Wma_Nursery_Chunk* nursery_full;    // Full chunks with live allocations, oldest first
+	Wma_Nursery_Chunk* nursery_last;    // Newest full chunk
+	Wma_Nursery_Chunk* nursery_spare;   // One empty chunk kept for reuse
+	uint32_t           nursery_clock;   // Number of nursery allocations so far
+#endif
 } Wma_Generic_Allocator;
 
 typedef union {
@@ -106,6 +200,23 @@ typedef union {
 	Wma_Generic_Allocator generic;
 } Wma_Global_Allocator;
 
+typedef enum {
+	WMA_HEAP_FAST    = WMA__fast,
+	WMA_HEAP_GENERIC = WMA__generic,
+} Wma_Heap_Kind;
+
+// Kind of a destroyed heap, none of the heap functions do anything with it
+#define WMA__HEAP_DESTROYED ((Wma_Heap_Kind)-1)
+
+typedef struct {
+	Wma_Heap_Kind kind;
+	uint32_t      initial_pages;
+	union {
+		Wma_Fast_Allocator    fast;
+		Wma_Generic_Allocator generic;
+	};
+} Wma_Heap;
+
 typedef struct Wma_Arena_Block {
 	struct Wma_Arena_Block* prev;
 } Wma_Arena_Block;
@@ -116,6 +227,9 @@ typedef struct {
 	Wma_Arena_Block* current;
 } Wma_Arena_Allocator;
 
+// Version of images made by wma_snapshot
+#define WMA_SNAPSHOT_VERSION 1
+
 // Size to WASM page count
 #define WMA_MB(AMOUNT) (16*(AMOUNT))
 
@@ -127,10 +241,38 @@ WMA_DEF void* wma_fast_realloc(Wma_Fast_Allocator* Allocator, void* Ptr, size_t
 WMA_DEF void* wma_fast_alloc  (Wma_Fast_Allocator* Allocator, size_t Size);
 WMA_DEF void  wma_fast_free   (Wma_Fast_Allocator* Allocator, void* Ptr);
 
+WMA_DEF size_t wma_fast_usable_size(Wma_Fast_Allocator* Allocator, void* Ptr);
+WMA_DEF int    wma_fast_try_expand (Wma_Fast_Allocator* Allocator, void* Ptr, size_t Size);
+
 WMA_DEF void* wma_generic_realloc(Wma_Generic_Allocator* Allocator, void* Ptr, size_t Size);
 WMA_DEF void* wma_generic_alloc  (Wma_Generic_Allocator* Allocator, size_t Size);
 WMA_DEF void  wma_generic_free   (Wma_Generic_Allocator* Allocator, void* Ptr);
 
+WMA_DEF size_t wma_generic_usable_size(Wma_Generic_Allocator* Allocator, void* Ptr);
+WMA_DEF int    wma_generic_try_expand (Wma_Generic_Allocator* Allocator, void* Ptr, size_t Size);
+
+WMA_DEF void  wma_heap_create (Wma_Heap* out_Heap, Wma_Heap_Kind Kind, uint32_t Initial_Pages);
+WMA_DEF void  wma_heap_reset  (Wma_Heap* Heap);
+WMA_DEF void  wma_heap_destroy(Wma_Heap* Heap);
+
+WMA_DEF void* wma_heap_realloc(Wma_Heap* Heap, void* Ptr, size_t Size);
+WMA_DEF void* wma_heap_alloc  (Wma_Heap* Heap, size_t Size);
+WMA_DEF void  wma_heap_free   (Wma_Heap* Heap, void* Ptr);
+
+WMA_DEF size_t wma_heap_usable_size(Wma_Heap* Heap, void* Ptr);
+WMA_DEF int    wma_heap_try_expand (Wma_Heap* Heap, void* Ptr, size_t Size);
+
+// Note: Heaps can be reset or destroyed in one go, regardless of how many
+//       allocations are live. All pointers into the heap become invalid.
+
+WMA_DEF size_t wma_snapshot(Wma_Heap* Heap, void* Buffer, size_t Buffer_Size);
+WMA_DEF int    wma_restore (Wma_Heap* out_Heap, const void* Image, size_t Image_Size);
+
+// Note: wma_snapshot returns the size of the image, and only writes it when
+//       `Buffer_Size` is large enough. wma_restore puts every page back at
+//       the same address, so it must run before anything else takes them
+//       (e.g. first thing in a fresh instance). Returns 0 on failure.
+
 WMA_DEF void wma_arena_allocator_create (Wma_Arena_Allocator* out_Allocator, uint32_t Page_Count);
 WMA_DEF void wma_arena_allocator_destroy(Wma_Arena_Allocator* Allocator);
 
@@ -144,6 +286,18 @@ WMA_DEF void  wma_arena_free    (Wma_Arena_Allocator* Allocator, void* Ptr);
 
 #ifdef WMA_IMPLEMENTATION
 
+#if defined(WMA_FAST_SIMD)
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#elif defined(WMA_64BIT) && defined(__SSE4_2__)
+#include <nmmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#endif
+
 #if defined(wma__panic)
 #define WMA__PANIC(TOPIC, WHAT) wma__panic(TOPIC, WHAT, __LINE__)
 #else
@@ -162,24 +316,24 @@ WMA_DEF void  wma_arena_free    (Wma_Arena_Allocator* Allocator, void* Ptr);
 #define wma__assert(EXPR) (void)0
 #endif
 
-static uint32_t wma__ceil_div(uint32_t Num, uint32_t Den)
+static Wma_Word wma__ceil_div(Wma_Word Num, Wma_Word Den)
 {
 	return (Num + Den - 1) / Den;
 }
 
-static uint32_t wma__min(uint32_t A, uint32_t B)
+static Wma_Word wma__min(Wma_Word A, Wma_Word B)
 {
 	return A < B ? A : B;
 }
 
-static uint32_t wma__max(uint32_t A, uint32_t B)
+static Wma_Word wma__max(Wma_Word A, Wma_Word B)
 {
 	return A < B ? B : A;
 }
 
 static void wma__memory_copy(void* Dst, void* Src, size_t Size)
 {
-	for (int i = 0; i < Size; ++i)
+	for (size_t i = 0; i < Size; ++i)
 	{
 		((uint8_t*)Dst)[i] = ((uint8_t*)Src)[i];
 	}
@@ -187,38 +341,361 @@ static void wma__memory_copy(void* Dst, void* Src, size_t Size)
 
 Wma_Global_Allocator wma_global_allocator = {0};
 
+// ~ Linear memory, counted in pages from address 0. Grow returns the old
+//   size, or -1 when out of memory. Define both to provide your own.
+#if !defined(wma__memory_grow) && defined(WMA_HOST)
+
+// Host backend:
+// Reserves `WMA_HOST_MAX_PAGES` of address space up front and hands it
+// out like WASM memory, for running natively or testing beyond 4GB.
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#if !defined(MAP_ANONYMOUS)
+#error "WMA_HOST needs MAP_ANONYMOUS, build with -std=gnu11 or define _DEFAULT_SOURCE"
+#endif
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+#endif
+
+// Plain number, so it can be checked against the address width
+#ifndef WMA_HOST_MAX_PAGES
+#if defined(WMA_64BIT)
+#define WMA_HOST_MAX_PAGES 131072 // 8GB
+#else
+#define WMA_HOST_MAX_PAGES 16384  // 1GB
+#endif
+#endif
+
+#if !defined(WMA_64BIT) && WMA_HOST_MAX_PAGES > 65534
+#error "WMA_HOST_MAX_PAGES does not fit in a 32-bit address space"
+#endif
+
+static Wma_Word wma__host_first_page = 0;
+static Wma_Word wma__host_page_count = 0;
+
+static Wma_Word wma__host_memory_size(void)
+{
+	if (!wma__host_first_page) {
+		// One extra page so the start can be aligned to a page
+		Wma_Word size = ((Wma_Word)WMA_HOST_MAX_PAGES + 1) * WMA_PAGE_SIZE;
+#if defined(_WIN32)
+		void* base = VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+		void* base = mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE, -1, 0);
+		if (base == MAP_FAILED) base = NULL;
+#endif
+		if (!base) {
+			WMA__PANIC("WMA", "Could not reserve address space");
+			return 0;
+		}
+		wma__host_first_page = wma__ceil_div((Wma_Word)base, WMA_PAGE_SIZE);
+	}
+	return wma__host_first_page + wma__host_page_count;
+}
+
+static Wma_Word wma__host_memory_grow(Wma_Word Page_Count)
+{
+	Wma_Word old_size = wma__host_memory_size();
+	if (!wma__host_first_page || wma__host_page_count + Page_Count > WMA_HOST_MAX_PAGES)
+		return (Wma_Word)-1;
+
+#if defined(_WIN32)
+	if (!VirtualAlloc((void*)(old_size * WMA_PAGE_SIZE), Page_Count * WMA_PAGE_SIZE, MEM_COMMIT, PAGE_READWRITE))
+		return (Wma_Word)-1;
+#endif
+	wma__host_page_count += Page_Count;
+	return old_size;
+}
+
+#define wma__memory_grow(PAGES) wma__host_memory_grow(PAGES)
+#define wma__memory_size()      wma__host_memory_size()
+
+// Nothing below the reserved range belongs to us
+#ifndef WMA_HEAP_BASE
+#define WMA_HEAP_BASE (wma__host_memory_size() * WMA_PAGE_SIZE)
+#endif
+
+#elif !defined(wma__memory_grow)
+#define wma__memory_grow(PAGES) ((Wma_Word)__builtin_wasm_memory_grow(0, PAGES))
+#define wma__memory_size()      ((Wma_Word)__builtin_wasm_memory_size(0))
+#endif
+
+// ~ Memory below this address is never touched (provided by the linker)
+#ifndef WMA_HEAP_BASE
+extern unsigned char __heap_base;
+#define WMA_HEAP_BASE ((Wma_Word)&__heap_base)
+#endif
+
+// Page Pool:
+// WASM memory can only grow, so pages released by a heap are kept
+// here (sorted by address, adjacent ranges merged) and handed out
+// again before asking for more memory.
+
+static Wma_Page_Chunk* wma__page_pool = NULL;
+static int             wma__page_pool_seeded = 0;
+
+// Bytes between `WMA_HEAP_BASE` and the next page, too small for the pool.
+// The global generic allocator starts its heap there.
+static Wma_Word wma__heap_tail      = 0;
+static Wma_Word wma__heap_tail_size = 0;
+
+static void wma__pages_release(Wma_Word Address, uint32_t Page_Count);
+
+// The module starts with some memory above `WMA_HEAP_BASE` that
+// nobody uses, hand those pages out before growing
+static void wma__page_pool_seed(void)
+{
+	if (wma__page_pool_seeded)
+		return;
+	wma__page_pool_seeded = 1;
+
+	Wma_Word first_page = wma__ceil_div(WMA_HEAP_BASE, WMA_PAGE_SIZE);
+	Wma_Word end_page   = wma__memory_size();
+	Wma_Word tail       = (WMA_HEAP_BASE + 7) & ~(Wma_Word)7;
+	if (first_page <= end_page && tail < first_page * WMA_PAGE_SIZE) {
+		wma__heap_tail      = tail;
+		wma__heap_tail_size = first_page * WMA_PAGE_SIZE - tail;
+	}
+	if (first_page < end_page) {
+		wma__pages_release(first_page * WMA_PAGE_SIZE, end_page - first_page);
+	}
+}
+
+static Wma_Word wma__page_pool_take(Wma_Page_Chunk** Link, uint32_t Page_Count)
+{
+	Wma_Page_Chunk* chunk = *Link;
+	Wma_Word address = (Wma_Word)chunk;
+
+	if (chunk->page_count == Page_Count) {
+		*Link = chunk->next;
+	}
+	else {
+		Wma_Page_Chunk* rest = (void*)(address + Page_Count * WMA_PAGE_SIZE);
+		rest->next       = chunk->next;
+		rest->page_count = chunk->page_count - Page_Count;
+		*Link = rest;
+	}
+	return address;
+}
+
+// Get `Page_Count` pages starting at or above `Min_Address`
+static Wma_Word wma__pages_acquire(Wma_Word Min_Address, uint32_t Page_Count)
+{
+	wma__page_pool_seed();
+	for (Wma_Page_Chunk** link = &wma__page_pool; *link; link = &(*link)->next)
+	{
+		if ((Wma_Word)*link < Min_Address)      continue;
+		if ((*link)->page_count < Page_Count) continue;
+
+		return wma__page_pool_take(link, Page_Count);
+	}
+
+	Wma_Word start_page = wma__memory_grow(Page_Count);
+	if (start_page == (Wma_Word)-1) {
+		WMA__PANIC("WMA", "Out of memory");
+	}
+	return start_page * WMA_PAGE_SIZE;
+}
+
+// Try to get `Page_Count` pages starting exactly at `Address`
+static int wma__pages_extend(Wma_Word Address, uint32_t Page_Count)
+{
+	wma__page_pool_seed();
+	for (Wma_Page_Chunk** link = &wma__page_pool; *link; link = &(*link)->next)
+	{
+		if ((Wma_Word)*link < Address) continue;
+		if ((Wma_Word)*link > Address) break;
+		if ((*link)->page_count < Page_Count) break;
+
+		wma__page_pool_take(link, Page_Count);
+		return 1;
+	}
+
+	if (wma__memory_size() * WMA_PAGE_SIZE != Address)
+		return 0;
+	return wma__memory_grow(Page_Count) != (Wma_Word)-1;
+}
+
+static void wma__pages_release(Wma_Word Address, uint32_t Page_Count)
+{
+	Wma_Page_Chunk* chunk = (void*)Address;
+	Wma_Page_Chunk* prev  = NULL;
+	Wma_Page_Chunk* next  = wma__page_pool;
+	while (next && (Wma_Word)next < Address) {
+		prev = next;
+		next = next->next;
+	}
+
+	chunk->next       = next;
+	chunk->page_count = Page_Count;
+
+	// Merge with range to the right
+	if (next && Address + Page_Count * WMA_PAGE_SIZE == (Wma_Word)next) {
+		chunk->page_count += next->page_count;
+		chunk->next        = next->next;
+	}
+	// Merge with range to the left
+	if (prev && (Wma_Word)prev + prev->page_count * WMA_PAGE_SIZE == Address) {
+		prev->page_count += chunk->page_count;
+		prev->next        = chunk->next;
+	}
+	else if (prev) {
+		prev->next = chunk;
+	}
+	else {
+		wma__page_pool = chunk;
+	}
+}
+
+static void wma__chunks_release(Wma_Page_Chunk* Chunks)
+{
+	while (Chunks)
+	{
+		Wma_Page_Chunk* next = Chunks->next;
+		wma__pages_release((Wma_Word)Chunks, Chunks->page_count);
+		Chunks = next;
+	}
+}
+
 // Fast Allocator Implementation:
 // There are a fixed number of allocations allowed.
 // Every 8 pages need a single page to bookkeep
-// the allocations.
+// the allocations, the slot table starts small
+// and grows as needed.
+// When the heap cannot grow in place, a new chunk is taken
+// and the hole before it is covered by a slot that is never freed.
+
+#if defined(WMA_FAST_SIMD)
+#define WMA__SLOT_ALLOCATED ((Wma_Word)1 << WMA__SIZE_BITS)
+
+static Wma_Slot wma__get_slot(Wma_Fast_Allocator* Allocator, uint32_t Index)
+{
+	Wma_Word size = Allocator->sizes[Index];
+	return (Wma_Slot) {
+		.offset    = Allocator->offsets[Index],
+		.allocated = size >> WMA__SIZE_BITS,
+		.size      = size & ~WMA__SLOT_ALLOCATED,
+	};
+}
+
+static void wma__set_slot(Wma_Fast_Allocator* Allocator, uint32_t Index, Wma_Slot Slot)
+{
+	Allocator->offsets[Index] = Slot.offset;
+	Allocator->sizes[Index]   = Slot.size | (Slot.allocated ? WMA__SLOT_ALLOCATED : 0);
+}
+#else
+static Wma_Slot wma__get_slot(Wma_Fast_Allocator* Allocator, uint32_t Index)
+{
+	return Allocator->slots[Index];
+}
+
+static void wma__set_slot(Wma_Fast_Allocator* Allocator, uint32_t Index, Wma_Slot Slot)
+{
+	Allocator->slots[Index] = Slot;
+}
+#endif
 
 static void wma_fast_allocator_reset(Wma_Fast_Allocator* Allocator)
 {
 	Allocator->first_free = 0;
 	Allocator->slot_count = 1;
-	Allocator->slots[0] = (Wma_Slot) { .size = Allocator->available_size };
+	Allocator->allocated  = 0;
+	wma__set_slot(Allocator, 0, (Wma_Slot) { .size = Allocator->available_size });
+}
+
+// Point the allocator at a new slot table, without moving any slots
+static void wma__fast_set_table(Wma_Fast_Allocator* Allocator, Wma_Page_Chunk* Table)
+{
+	uint32_t capacity = (Table->page_count * WMA_PAGE_SIZE - sizeof(Wma_Page_Chunk)) / sizeof(Wma_Slot) - 1;
+	Allocator->start         = (Wma_Word)Table;
+	Allocator->slot_capacity = wma__min(capacity, Allocator->slot_limit);
+#if defined(WMA_FAST_SIMD)
+	Allocator->offsets       = (Wma_Word*)(Table + 1);
+	Allocator->sizes         = Allocator->offsets + capacity + 1;
+#else
+	Allocator->slots         = (Wma_Slot*)(Table + 1);
+#endif
 }
 
-static void wma_fast_allocator_create(Wma_Fast_Allocator* out_Allocator, uint32_t Max_Allocations)
+static void wma_fast_allocator_create(Wma_Fast_Allocator* out_Allocator, uint32_t Max_Allocations, uint32_t Page_Count)
 {
 	wma__assert(out_Allocator != NULL);
 	wma__assert(Max_Allocations != 0);
 
-	// Allocate memory required
-	int num_bookkeep_pages = wma__ceil_div(Max_Allocations, WMA_PAGE_SIZE / sizeof(Wma_Slot));
-	int pages_required = num_bookkeep_pages + 1;
-	int start_page = __builtin_wasm_memory_grow(0, pages_required);
+	// Slot table starts with a single page, it grows as slots are used
+	Wma_Page_Chunk* table = (void*)wma__pages_acquire(0, 1);
+	table->next       = NULL;
+	table->page_count = 1;
+
+	// Heap goes after the table, so it is free to grow in place
+	Page_Count = wma__max(Page_Count, 1);
+	Wma_Page_Chunk* chunk = (void*)wma__pages_acquire(0, Page_Count);
+	chunk->next       = NULL;
+	chunk->page_count = Page_Count;
 
 	// Setup heap data structure
-	out_Allocator->start          = start_page * WMA_PAGE_SIZE;
-	out_Allocator->heap_start     = (start_page + num_bookkeep_pages) * WMA_PAGE_SIZE;
-	out_Allocator->total_size     = pages_required * WMA_PAGE_SIZE;
-	out_Allocator->available_size = WMA_PAGE_SIZE;
-	out_Allocator->slot_capacity  = num_bookkeep_pages * WMA_PAGE_SIZE / sizeof(Wma_Slot) - 1;
-	out_Allocator->slots          = (Wma_Slot*)out_Allocator->start;
+	out_Allocator->heap_start     = (Wma_Word)(chunk + 1);
+	out_Allocator->total_size     = (1 + Page_Count) * WMA_PAGE_SIZE;
+	out_Allocator->available_size = Page_Count * WMA_PAGE_SIZE - sizeof(Wma_Page_Chunk);
+	out_Allocator->slot_limit     = Max_Allocations;
+	out_Allocator->chunks         = chunk;
+	wma__fast_set_table(out_Allocator, table);
 	wma_fast_allocator_reset(out_Allocator);
 }
 
+// Make sure there is room for `Count` more slots,
+// doubling the slot table (moving it if needed) when full
+static int wma__fast_reserve_slots(Wma_Fast_Allocator* Allocator, uint32_t Count)
+{
+	if (Allocator->slot_count + Count <= Allocator->slot_capacity) return 1;
+	if (Allocator->slot_capacity >= Allocator->slot_limit)         return 0;
+
+	Wma_Page_Chunk* table = (void*)Allocator->start;
+	uint32_t count     = Allocator->slot_count;
+	uint32_t old_pages = table->page_count;
+	uint32_t max_pages = wma__ceil_div((Allocator->slot_limit + 1) * sizeof(Wma_Slot) + sizeof(Wma_Page_Chunk), WMA_PAGE_SIZE);
+	uint32_t pages     = wma__min(old_pages * 2, max_pages);
+#if defined(WMA_FAST_SIMD)
+	Wma_Word* old_offsets = Allocator->offsets;
+	Wma_Word* old_sizes   = Allocator->sizes;
+#else
+	Wma_Slot* old_slots   = Allocator->slots;
+#endif
+
+	if (wma__pages_extend(Allocator->start + old_pages * WMA_PAGE_SIZE, pages - old_pages)) {
+		table->page_count = pages;
+		wma__fast_set_table(Allocator, table);
+#if defined(WMA_FAST_SIMD)
+		// Sizes move up, so copy from the end
+		for (uint32_t i = count; i-- > 0;)
+			Allocator->sizes[i] = old_sizes[i];
+#endif
+	}
+	else {
+		Wma_Page_Chunk* new_table = (void*)wma__pages_acquire(0, pages);
+		new_table->next       = NULL;
+		new_table->page_count = pages;
+		wma__fast_set_table(Allocator, new_table);
+#if defined(WMA_FAST_SIMD)
+		wma__memory_copy(Allocator->offsets, old_offsets, count * sizeof(Wma_Word));
+		wma__memory_copy(Allocator->sizes,   old_sizes,   count * sizeof(Wma_Word));
+#else
+		wma__memory_copy(Allocator->slots, old_slots, count * sizeof(Wma_Slot));
+#endif
+		wma__pages_release((Wma_Word)table, old_pages);
+	}
+
+	Allocator->total_size += (pages - old_pages) * WMA_PAGE_SIZE;
+	return Allocator->slot_count + Count <= Allocator->slot_capacity;
+}
+
 // [i-1][ i ][i+1][i+2]
 //           ---->
 // [i-1][ i ][ i ][i+1][i+2]
@@ -227,25 +704,32 @@ static void wma__shift_slots_up(Wma_Fast_Allocator* Allocator, uint32_t Index)
 	uint32_t count = Allocator->slot_count;
 	wma__assert(count < Allocator->slot_capacity);
 
+#if defined(WMA_FAST_SIMD)
+	for (uint32_t i = count; i > Index; --i)
+		Allocator->offsets[i] = Allocator->offsets[i-1];
+	for (uint32_t i = count; i > Index; --i)
+		Allocator->sizes[i] = Allocator->sizes[i-1];
+#else
 	for (uint32_t i = count; i > Index; --i)
 		Allocator->slots[i] = Allocator->slots[i-1];
+#endif
 }
 
 static void* wma__assign_slot(Wma_Fast_Allocator* Allocator, uint32_t Index, size_t Size)
 {
-	Wma_Slot* slot = &Allocator->slots[Index];
+	Wma_Slot slot = wma__get_slot(Allocator, Index);
 
 	// Fit slot to size, if we are able to create a new free slot
-	if (slot->size > Size && Allocator->slot_count < Allocator->slot_capacity) {
+	if (slot.size > Size && wma__fast_reserve_slots(Allocator, 1)) {
 		// Make room so we can insert a new slot
 		wma__shift_slots_up(Allocator, Index+1);
 		// Create new slot with remaining space
-		Allocator->slots[Index+1] = (Wma_Slot) {
-			.offset = slot->offset + Size,
-			.size   = slot->size - Size,
-		};
+		wma__set_slot(Allocator, Index+1, (Wma_Slot) {
+			.offset = slot.offset + Size,
+			.size   = slot.size - Size,
+		});
 		// Resize this slot to fit allocation
-		slot->size = Size;
+		slot.size = Size;
 		Allocator->slot_count += 1;
 	}
 
@@ -254,97 +738,242 @@ static void* wma__assign_slot(Wma_Fast_Allocator* Allocator, uint32_t Index, siz
 		Allocator->first_free += 1;
 	}
 	
-	slot->allocated = 1;
-	Allocator->allocated += slot->size;
-	return (void*)(Allocator->heap_start + slot->offset);
+	slot.allocated = 1;
+	wma__set_slot(Allocator, Index, slot);
+	Allocator->allocated += slot.size;
+	return (void*)(Allocator->heap_start + slot.offset);
 }
 
-WMA_DEF void* wma_fast_alloc(Wma_Fast_Allocator* Allocator, size_t Size)
+// Append free space to the end of the heap so that the
+// last slot is free and can hold `Size` bytes.
+// Returns the index of the last slot.
+static uint32_t wma__fast_grow(Wma_Fast_Allocator* Allocator, size_t Size)
 {
-	if (Allocator->available_size == 0)
-		wma_fast_allocator_create(Allocator, WMA_FAST_MAX_ALLOCATIONS);
-	
-	for (uint32_t i = Allocator->first_free; i < Allocator->slot_count; ++i)
+	Wma_Word end = Allocator->heap_start + Allocator->available_size;
+	Wma_Slot last_slot = wma__get_slot(Allocator, Allocator->slot_count-1);
+	int last_is_free = last_slot.allocated == 0;
+
+	// 1. Grow in place, extending the last slot if it is free
+	Wma_Word grow_amount = last_is_free ? Size - last_slot.size : Size;
+	uint32_t grow_pages = wma__ceil_div(grow_amount, WMA_PAGE_SIZE);
+
+	if ((last_is_free || wma__fast_reserve_slots(Allocator, 1))
+	&&  wma__pages_extend(end, grow_pages))
 	{
-		Wma_Slot* slot = &Allocator->slots[i];
-		
-		if (slot->allocated)   continue;
-		if (slot->size < Size) continue;
-		
-		return wma__assign_slot(Allocator, i, Size);
+		Allocator->chunks->page_count += grow_pages;
+		Allocator->total_size         += WMA_PAGE_SIZE * grow_pages;
+		Allocator->available_size     += WMA_PAGE_SIZE * grow_pages;
+
+		if (last_is_free) {
+			last_slot.size += WMA_PAGE_SIZE * grow_pages;
+		}
+		else {
+			Allocator->slot_count += 1;
+			last_slot = (Wma_Slot) {
+				.offset = end - Allocator->heap_start,
+				.size   = WMA_PAGE_SIZE * grow_pages,
+			};
+		}
+		wma__set_slot(Allocator, Allocator->slot_count - 1, last_slot);
+		wma__assert(last_slot.size >= Size);
+		return Allocator->slot_count - 1;
 	}
 
-	// Failed to find a slot that is both free and with enough space
-	// We have 2 options now:
+	// 2. Take a new chunk somewhere above the heap, and insert
+	//    a slot that covers the hole before it
+	if (!wma__fast_reserve_slots(Allocator, 2)) {
+		WMA__PANIC("WMA", "Maximum number of allocations reached");
+	}
 
-	// 1. Grow the last slot
-	Wma_Slot* last_slot = &Allocator->slots[Allocator->slot_count-1];
-	if (last_slot->allocated == 0) {
-		uint32_t grow_amount = Size - last_slot->size;
-		uint32_t grow_pages = wma__ceil_div(grow_amount, WMA_PAGE_SIZE);
+	grow_pages = wma__ceil_div(Size + sizeof(Wma_Page_Chunk), WMA_PAGE_SIZE);
+	Wma_Word start = wma__pages_acquire(end, grow_pages);
+
+	Wma_Page_Chunk* chunk = (void*)start;
+	chunk->next       = Allocator->chunks;
+	chunk->page_count = grow_pages;
+	Allocator->chunks = chunk;
+
+	wma__set_slot(Allocator, Allocator->slot_count++, (Wma_Slot) {
+		.offset    = end - Allocator->heap_start,
+		.size      = (Wma_Word)(chunk + 1) - end,
+		.allocated = 1,
+	});
+	last_slot = (Wma_Slot) {
+		.offset = (Wma_Word)(chunk + 1) - Allocator->heap_start,
+		.size   = WMA_PAGE_SIZE * grow_pages - sizeof(Wma_Page_Chunk),
+	};
+	wma__set_slot(Allocator, Allocator->slot_count++, last_slot);
+
+	Allocator->total_size    += WMA_PAGE_SIZE * grow_pages;
+	Allocator->available_size = start + WMA_PAGE_SIZE * grow_pages - Allocator->heap_start;
+
+	wma__assert(last_slot.size >= Size);
+	return Allocator->slot_count - 1;
+}
 
-		__builtin_wasm_memory_grow(0, grow_pages);
-		Allocator->total_size     += WMA_PAGE_SIZE * grow_pages;
-		Allocator->available_size += WMA_PAGE_SIZE * grow_pages;
+// Index of the first free slot that can hold `Size` bytes,
+// or `slot_count` if there is none.
+// With WMA_FAST_SIMD, the allocated bit is the sign bit of each size,
+// so a single signed compare tests four slots at once.
+static uint32_t wma__fast_find_free(Wma_Fast_Allocator* Allocator, size_t Size)
+{
+	uint32_t i = Allocator->first_free;
+	uint32_t count = Allocator->slot_count;
 
-		last_slot->size += WMA_PAGE_SIZE * grow_pages;
-		wma__assert(last_slot->size >= Size);
+#if defined(WMA_FAST_SIMD)
+	if (Size >= WMA__SLOT_ALLOCATED)
+		return count;
 
-		return wma__assign_slot(Allocator, Allocator->slot_count - 1, Size);
+#if defined(WMA_64BIT)
+	int64_t smaller = (int64_t)Size - 1;
+	const uint64_t* sizes = Allocator->sizes;
+#if defined(__wasm_simd128__)
+	v128_t needle = wasm_i64x2_splat(smaller);
+	for (; i + 2 <= count; i += 2)
+	{
+		uint32_t mask = wasm_i64x2_bitmask(wasm_i64x2_gt(wasm_v128_load(sizes + i), needle));
+		if (mask) return i + __builtin_ctz(mask);
 	}
-
-	// 2. Grow the heap and insert a new slot
-	if (Allocator->slot_count == Allocator->slot_capacity) {
-		WMA__PANIC("WMA", "Maximum number of allocations reached");
+#elif defined(__SSE4_2__)
+	__m128i needle = _mm_set1_epi64x(smaller);
+	for (; i + 2 <= count; i += 2)
+	{
+		__m128i fits = _mm_cmpgt_epi64(_mm_loadu_si128((const __m128i*)(sizes + i)), needle);
+		uint32_t mask = _mm_movemask_pd(_mm_castsi128_pd(fits));
+		if (mask) return i + __builtin_ctz(mask);
+	}
+#elif defined(__SSE2__)
+	// No 64-bit compare, so compare the high halves (signed) and fall
+	// back to the low halves (unsigned, by flipping their sign bit) when equal
+	__m128i flip   = _mm_set1_epi64x(0x80000000);
+	__m128i needle = _mm_xor_si128(_mm_set1_epi64x(smaller), flip);
+	for (; i + 2 <= count; i += 2)
+	{
+		__m128i value = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(sizes + i)), flip);
+		__m128i gt = _mm_cmpgt_epi32(value, needle);
+		__m128i eq = _mm_cmpeq_epi32(value, needle);
+		__m128i fits = _mm_or_si128(
+			_mm_shuffle_epi32(gt, _MM_SHUFFLE(3,3,1,1)),
+			_mm_and_si128(_mm_shuffle_epi32(eq, _MM_SHUFFLE(3,3,1,1)), _mm_shuffle_epi32(gt, _MM_SHUFFLE(2,2,0,0))));
+		uint32_t mask = _mm_movemask_pd(_mm_castsi128_pd(fits));
+		if (mask) return i + __builtin_ctz(mask);
+	}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	int64x2_t needle = vdupq_n_s64(smaller);
+	for (; i + 2 <= count; i += 2)
+	{
+		uint64x2_t fits = vcgtq_s64(vld1q_s64((const int64_t*)(sizes + i)), needle);
+		if (vmaxvq_u32(vreinterpretq_u32_u64(fits))) break;
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		if ((int64_t)sizes[i] > smaller) return i;
+	}
+#else
+	int32_t smaller = (int32_t)Size - 1;
+	const uint32_t* sizes = Allocator->sizes;
+#if defined(__wasm_simd128__)
+	v128_t needle = wasm_i32x4_splat(smaller);
+	for (; i + 4 <= count; i += 4)
+	{
+		uint32_t mask = wasm_i32x4_bitmask(wasm_i32x4_gt(wasm_v128_load(sizes + i), needle));
+		if (mask) return i + __builtin_ctz(mask);
+	}
+#elif defined(__SSE2__)
+	__m128i needle = _mm_set1_epi32(smaller);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i fits = _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i*)(sizes + i)), needle);
+		uint32_t mask = _mm_movemask_ps(_mm_castsi128_ps(fits));
+		if (mask) return i + __builtin_ctz(mask);
+	}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	int32x4_t needle = vdupq_n_s32(smaller);
+	for (; i + 4 <= count; i += 4)
+	{
+		uint32x4_t fits = vcgtq_s32(vld1q_s32((const int32_t*)(sizes + i)), needle);
+		if (vmaxvq_u32(fits)) break;
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		if ((int32_t)sizes[i] > smaller) return i;
+	}
+#endif
+#else
+	for (; i < count; ++i)
+	{
+		Wma_Slot* slot = &Allocator->slots[i];
+		
+		if (slot->allocated)   continue;
+		if (slot->size < Size) continue;
+		
+		return i;
 	}
+#endif
+	return count;
+}
 
-	uint32_t grow_pages = wma__ceil_div(Size, WMA_PAGE_SIZE);
-	last_slot = &Allocator->slots[Allocator->slot_count];
-	last_slot->offset = Allocator->available_size;
-	last_slot->size   = WMA_PAGE_SIZE * grow_pages;
-	Allocator->slot_count += 1;
-	wma__assert(last_slot->size >= Size);
+WMA_DEF void* wma_fast_alloc(Wma_Fast_Allocator* Allocator, size_t Size)
+{
+	if (Allocator->chunks == NULL)
+		wma_fast_allocator_create(Allocator, WMA_FAST_MAX_ALLOCATIONS, 1);
+	
+	uint32_t index = wma__fast_find_free(Allocator, Size);
 
-	__builtin_wasm_memory_grow(0, grow_pages);
-	Allocator->total_size     += WMA_PAGE_SIZE * grow_pages;
-	Allocator->available_size += WMA_PAGE_SIZE * grow_pages;
+	// Failed to find a slot that is both free and with enough space
+	if (index == Allocator->slot_count)
+		index = wma__fast_grow(Allocator, Size);
 
-	return wma__assign_slot(Allocator, Allocator->slot_count - 1, Size);
+	return wma__assign_slot(Allocator, index, Size);
 }
 
 static void wma__shift_slots_down(Wma_Fast_Allocator* Allocator, uint32_t Index)
 {
 	uint32_t count = Allocator->slot_count;
 	wma__assert(count > 0);
+#if defined(WMA_FAST_SIMD)
+	for (uint32_t i = Index; i < count; ++i)
+		Allocator->offsets[i] = Allocator->offsets[i+1];
+	for (uint32_t i = Index; i < count; ++i)
+		Allocator->sizes[i] = Allocator->sizes[i+1];
+#else
 	for (uint32_t i = Index; i < count; ++i)
 		Allocator->slots[i] = Allocator->slots[i+1];
+#endif
 	Allocator->slot_count -= 1;
 }
 
 static void wma__fast_free_slot(Wma_Fast_Allocator* Allocator, uint32_t Index)
 {
-	Wma_Slot* slot = &Allocator->slots[Index];
+	Wma_Slot slot = wma__get_slot(Allocator, Index);
 	uint32_t count = Allocator->slot_count;
 	uint32_t index = Index;
-	slot->allocated = 0;
-	Allocator->allocated -= slot->size;
+	slot.allocated = 0;
+	Allocator->allocated -= slot.size;
 
 	// Combine with slot to the right
 	if (Index < count-1) {
-		if (Allocator->slots[Index+1].allocated == 0) {
-			slot->size += Allocator->slots[Index+1].size;
+		Wma_Slot right = wma__get_slot(Allocator, Index+1);
+		if (right.allocated == 0) {
+			slot.size += right.size;
 			wma__shift_slots_down(Allocator, Index+1);
 		}
 	}
 	// Combine with slot to the left
 	if (Index > 0) {
-		if (Allocator->slots[Index-1].allocated == 0) {
-			Allocator->slots[Index-1].size += slot->size;
+		Wma_Slot left = wma__get_slot(Allocator, Index-1);
+		if (left.allocated == 0) {
+			slot.offset = left.offset;
+			slot.size  += left.size;
 			wma__shift_slots_down(Allocator, Index);
 			index = Index - 1;
 		}
 	}
 
+	wma__set_slot(Allocator, index, slot);
+
 	if (Allocator->first_free > index) {
 		Allocator->first_free = index;
 	}
@@ -352,18 +981,18 @@ static void wma__fast_free_slot(Wma_Fast_Allocator* Allocator, uint32_t Index)
 
 static uint32_t wma__fast_find_slot(Wma_Fast_Allocator* Allocator, void* Ptr)
 {
-	uint32_t offset = (uint32_t)Ptr - Allocator->heap_start;
+	Wma_Word offset = (Wma_Word)Ptr - Allocator->heap_start;
 	uint32_t left = 0;
 	uint32_t right = Allocator->slot_count - 1;
 	while (left <= right)
 	{
 		uint32_t mid = (left + right) / 2;
-		Wma_Slot* mid_slot = &Allocator->slots[mid];
+		Wma_Word mid_offset = wma__get_slot(Allocator, mid).offset;
 
-		if (mid_slot->offset < offset) {
+		if (mid_offset < offset) {
 			left = mid + 1;
 		}
-		else if (mid_slot->offset > offset) {
+		else if (mid_offset > offset) {
 			right = mid - 1;
 		}
 		else {
@@ -380,6 +1009,50 @@ WMA_DEF void wma_fast_free(Wma_Fast_Allocator* Allocator, void* Ptr)
 	wma__fast_free_slot(Allocator, index);
 }
 
+// Grow the slot at `Index` into the free slot after it
+static int wma__fast_try_extend(Wma_Fast_Allocator* Allocator, uint32_t Index, size_t Size)
+{
+	Wma_Slot slot = wma__get_slot(Allocator, Index);
+	if (Size <= slot.size)
+		return 1;
+
+	Wma_Word grow_amount = Size - slot.size;
+	if (Index + 1 >= Allocator->slot_count)
+		return 0;
+
+	Wma_Slot next_slot = wma__get_slot(Allocator, Index+1);
+	if (next_slot.allocated)          return 0;
+	if (next_slot.size < grow_amount) return 0;
+
+	next_slot.size -= grow_amount;
+	if (next_slot.size == 0) {
+		wma__shift_slots_down(Allocator, Index+1);
+	}
+	else {
+		next_slot.offset += grow_amount;
+		wma__set_slot(Allocator, Index+1, next_slot);
+	}
+
+	slot.size = Size;
+	wma__set_slot(Allocator, Index, slot);
+	Allocator->allocated += grow_amount;
+	return 1;
+}
+
+WMA_DEF size_t wma_fast_usable_size(Wma_Fast_Allocator* Allocator, void* Ptr)
+{
+	uint32_t index = wma__fast_find_slot(Allocator, Ptr);
+	wma__assert(index < Allocator->slot_count);
+	return wma__get_slot(Allocator, index).size;
+}
+
+WMA_DEF int wma_fast_try_expand(Wma_Fast_Allocator* Allocator, void* Ptr, size_t Size)
+{
+	uint32_t index = wma__fast_find_slot(Allocator, Ptr);
+	wma__assert(index < Allocator->slot_count);
+	return wma__fast_try_extend(Allocator, index, Size);
+}
+
 WMA_DEF void* wma_fast_realloc(Wma_Fast_Allocator* Allocator, void* Ptr, size_t Size)
 {
 	if (Ptr == NULL)
@@ -390,26 +1063,9 @@ WMA_DEF void* wma_fast_realloc(Wma_Fast_Allocator* Allocator, void* Ptr, size_t
 	wma__assert(index < Allocator->slot_count);
 
 	// Try to extend this slot
-	uint32_t old_size = Allocator->slots[index].size;
-	uint32_t grow_amount = Size - old_size;
-	uint32_t count = Allocator->slot_count;
-	for (;index < count-1;) {
-		Wma_Slot* next_slot = &Allocator->slots[index+1];
-		
-		if (next_slot->allocated)          break;
-		if (next_slot->size < grow_amount) break;
-			
-		next_slot->size -= grow_amount;
-		if (next_slot->size == 0) {
-			wma__shift_slots_down(Allocator, index+1);
-		}
-		else {
-			Allocator->slots[index+1].offset += grow_amount;
-		}
-
-		Allocator->slots[index].size = Size;
+	Wma_Word old_size = wma__get_slot(Allocator, index).size;
+	if (wma__fast_try_extend(Allocator, index, Size))
 		return Ptr;
-	}
 
 	// Extending failed, so free this slot and allocate another
 	wma__fast_free_slot(Allocator, index);
@@ -418,61 +1074,201 @@ WMA_DEF void* wma_fast_realloc(Wma_Fast_Allocator* Allocator, void* Ptr, size_t
 	return ptr;
 }
 
+// Region sizes are kept a multiple of 8, so headers and payloads stay word aligned
+#define WMA__ALIGN(X) (((X) + 7) & ~(Wma_Word)7)
+
 static int wma__bucket_index(size_t Size)
 {
 	if (Size < 128) return (Size >> 3) - 1;
+#if defined(WMA_64BIT)
+	// Counted as if `Size` was 32-bit, so it goes negative above 4GB.
+	// Sizes from 128MB up get their own buckets instead of sharing the last one.
+	int clz = __builtin_clzll(Size) - 32;
+#else
 	int clz = __builtin_clz(Size);
+#endif
 	return (clz > 19)
-		?          110 - (clz<<2) + ((Size >> (29-clz)) ^ 4)
-		: wma__min( 71 - (clz<<1) + ((Size >> (30-clz)) ^ 2), 63);
+		?          110 - clz*4 + ((Size >> (29-clz)) ^ 4)
+		: wma__min( 71 - clz*2 + ((Size >> (30-clz)) ^ 2), WMA__BUCKET_COUNT-1);
 }
 
 static int wma__regions_are_adjacent(Wma_Region* Left, Wma_Region* Right)
 {
-	return (uint32_t)(Left + 1) + Left->size == (uint32_t)Right;
+	return (Wma_Word)(Left + 1) + Left->size == (Wma_Word)Right;
 }
 
 static void* wma__generic_try_allocate(Wma_Generic_Allocator* Allocator, uint32_t Bucket_Index, Wma_Region* Region, size_t Size)
 {
 	if (Region->size < Size)
 		return WMA_INVALID;
-	
+
+	// Whatever is left over takes the place of `Region` in its list
+	Wma_Region* prev = Region->prev;
+	Wma_Region* next = Region->next;
+	Wma_Region* rest = NULL;
 	if (Region->size > Size + sizeof(Wma_Region)) {
-		Wma_Region* new_region = (void*)((uint32_t)(Region + 1) + Size);
-		new_region->size = Region->size - Size - sizeof(Wma_Region);
-		new_region->prev = Region;
-		new_region->next = Region->next;
-		Region->next = new_region;
+		rest = (void*)((Wma_Word)(Region + 1) + Size);
+		rest->size = Region->size - Size - sizeof(Wma_Region);
+		rest->used = 0;
+		rest->prev = prev;
+		rest->next = next;
 		Region->size = Size;
-	
-		wma__assert(wma__regions_are_adjacent(Region, new_region));
+
+		wma__assert(wma__regions_are_adjacent(Region, rest));
 	}
 
-	// Connect the two free regions inbetween
-	if (Region->prev) {
-		Region->prev->next = Region->next;
+	if (prev) {
+		prev->next = rest ? rest : next;
 	}
 	else {
-		Allocator->heads[Bucket_Index] = Region->next;
+		Allocator->heads[Bucket_Index] = rest ? rest : next;
 	}
-	if (Region->next) {
-		Region->next->prev = Region->prev;
+	if (next) {
+		next->prev = rest ? rest : prev;
 	}
 	else {
-		Allocator->tails[Bucket_Index] = Region->prev;
+		Allocator->tails[Bucket_Index] = rest ? rest : prev;
 	}
 
 	Region->used = 1;
 	return Region + 1;
 }
 
-WMA_DEF void* wma_generic_alloc(Wma_Generic_Allocator* Allocator, size_t Size)
+// Make a free region of `Size` bytes at `At`, followed by an empty used region
+static Wma_Region* wma__generic_region_init(void* At, Wma_Word Size)
 {
-    int bucket_index = wma__bucket_index(wma__max(Size, 8));
+	Wma_Region* region = At;
+	region->size = Size;
+	region->used = 0;
+	region->prev = NULL;
+	region->next = NULL;
 
-    Wma_Region* region = Allocator->heads[bucket_index];
-    while (region)
-	{
+	Wma_Region* end = (void*)((Wma_Word)(region + 1) + region->size);
+	*end = (Wma_Region) { .used = 1 };
+	return region;
+}
+
+// Get a new free region that can hold at least `Size` bytes,
+// reserved pages are used first, then pages from the page pool.
+// The pages end with an empty used region, so the region after
+// any region can always be looked at.
+static Wma_Region* wma__generic_grow(Wma_Generic_Allocator* Allocator, size_t Size)
+{
+	Wma_Word overhead = 2 * sizeof(Wma_Region);
+	uint32_t pages_required = wma__ceil_div(Size + overhead, WMA_PAGE_SIZE);
+	Wma_Region* region;
+
+	// Only the global allocator can use the partial page above `WMA_HEAP_BASE`,
+	// heaps have to be able to give back everything they own
+	wma__page_pool_seed();
+	if (Allocator == &wma_global_allocator.generic && wma__heap_tail_size >= Size + overhead) {
+		region = (void*)wma__heap_tail;
+		Wma_Word size = wma__heap_tail_size - overhead;
+		wma__heap_tail_size = 0;
+		return wma__generic_region_init(region, size);
+	}
+
+	if (Allocator->base_used + pages_required <= Allocator->base_pages) {
+		region = (void*)(Allocator->base + Allocator->base_used * WMA_PAGE_SIZE);
+		Allocator->base_used += pages_required;
+	}
+	else {
+		overhead += sizeof(Wma_Page_Chunk);
+		pages_required = wma__ceil_div(Size + overhead, WMA_PAGE_SIZE);
+		Wma_Page_Chunk* chunk = (void*)wma__pages_acquire(0, pages_required);
+		chunk->next       = Allocator->chunks;
+		chunk->page_count = pages_required;
+		Allocator->chunks = chunk;
+
+		region = (void*)(chunk + 1);
+	}
+
+	return wma__generic_region_init(region, pages_required * WMA_PAGE_SIZE - overhead);
+}
+
+// Add a free region to the end of a bucket list
+static void wma__generic_append(Wma_Generic_Allocator* Allocator, int Bucket_Index, Wma_Region* Region)
+{
+	if (Allocator->heads[Bucket_Index] == NULL) {
+		Allocator->heads[Bucket_Index] = Region;
+		Allocator->tails[Bucket_Index] = Region;
+	}
+	else {
+		Wma_Region* last = Allocator->tails[Bucket_Index];
+		Region->prev = last;
+		last->next = Region;
+		Allocator->tails[Bucket_Index] = Region;
+	}
+}
+
+// Index of the bucket list that `Region` is the head or tail of
+static int wma__generic_list_index(Wma_Generic_Allocator* Allocator, Wma_Region* Region)
+{
+	for (int i = 0; i < WMA__BUCKET_COUNT; ++i)
+	{
+		if (Allocator->heads[i] == Region || Allocator->tails[i] == Region)
+			return i;
+	}
+	return -1;
+}
+
+// Take a free region out of the bucket list it is in
+static void wma__generic_unlink(Wma_Generic_Allocator* Allocator, Wma_Region* Region)
+{
+	Wma_Region* prev = Region->prev;
+	Wma_Region* next = Region->next;
+	int list_index = (prev && next) ? -1 : wma__generic_list_index(Allocator, Region);
+
+	if (prev) {
+		prev->next = next;
+	}
+	else {
+		Allocator->heads[list_index] = next;
+	}
+	if (next) {
+		next->prev = prev;
+	}
+	else {
+		Allocator->tails[list_index] = prev;
+	}
+}
+
+// Merge the free regions that follow `Region` into it.
+// Regions do not know where the one before them starts, so a free
+// region only merges forward: when it is freed, and when an
+// allocation looks at it.
+static void wma__combine_regions(Wma_Generic_Allocator* Allocator, Wma_Region* Region)
+{
+	for (;;)
+	{
+		Wma_Region* next = (void*)((Wma_Word)(Region + 1) + Region->size);
+		if (next->used)
+			return;
+		wma__generic_unlink(Allocator, next);
+		Region->size += sizeof(Wma_Region) + next->size;
+	}
+}
+
+// Put a region back in the bucket list for its size,
+// merged with the free regions after it
+static void wma__generic_insert(Wma_Generic_Allocator* Allocator, Wma_Region* Region)
+{
+	Region->used = 0;
+	Region->prev = NULL;
+	Region->next = NULL;
+	wma__combine_regions(Allocator, Region);
+	wma__generic_append(Allocator, wma__bucket_index(wma__max(Region->size, 8)), Region);
+}
+
+static void* wma__generic_alloc(Wma_Generic_Allocator* Allocator, size_t Size)
+{
+	Size = WMA__ALIGN(Size);
+    int bucket_index = wma__bucket_index(wma__max(Size, 8));
+
+    Wma_Region* region = Allocator->heads[bucket_index];
+    while (region)
+	{
+		wma__combine_regions(Allocator, region);
 		void* ptr = wma__generic_try_allocate(Allocator, bucket_index, region, Size);	
 		if (ptr != WMA_INVALID)
 			return ptr;
@@ -480,31 +1276,353 @@ WMA_DEF void* wma_generic_alloc(Wma_Generic_Allocator* Allocator, size_t Size)
 		region = region->next;
     }
 
-	uint32_t pages_required = wma__ceil_div(Size + sizeof(Wma_Region), WMA_PAGE_SIZE);
-	uint32_t start_page = __builtin_wasm_memory_grow(0, pages_required);
-	region = (void*)(start_page * WMA_PAGE_SIZE);
-	region->size = pages_required * WMA_PAGE_SIZE - sizeof(Wma_Region);
-	region->used = 0;
-	region->prev = NULL;
-	region->next = NULL;
+	// Larger buckets hold larger regions, so their first region usually fits
+	for (int i = bucket_index + 1; i < WMA__BUCKET_COUNT; ++i)
+	{
+		region = Allocator->heads[i];
+		if (region == NULL)
+			continue;
+		wma__combine_regions(Allocator, region);
+		void* ptr = wma__generic_try_allocate(Allocator, i, region, Size);
+		if (ptr != WMA_INVALID)
+			return ptr;
+	}
+
+	region = wma__generic_grow(Allocator, Size);
+	wma__generic_append(Allocator, bucket_index, region);
+
+    return wma__generic_try_allocate(Allocator, bucket_index, region, Size);
+}
+
+#if defined(WMA_GENERIC_NURSERY)
+
+// Nursery:
+// Most small allocations die young, so they are bump allocated from
+// separate chunks that count how many are still live. A chunk is a used
+// region of the heap, taken from free space in the heap when there is
+// enough, otherwise from new pages. The chunk being allocated from
+// starts over when its count hits zero. Full chunks wait in a list
+// (oldest first), empty ones go back to the heap except for one spare.
+// Full chunks that still hold allocations `WMA_NURSERY_AGE` nursery
+// allocations later are retired: their dead space becomes free regions
+// of the heap, and the survivors become ordinary regions.
+// Nursery allocations have a region header with `prev` set to
+// `WMA__NURSERY_TAG` and `next` pointing at their chunk, the region
+// holding a chunk has `prev` set to `WMA__NURSERY_CHUNK_TAG`.
+
+#define WMA__NURSERY_TAG       ((Wma_Region*)WMA_INVALID)
+#define WMA__NURSERY_CHUNK_TAG ((Wma_Region*)~(Wma_Word)1)
+
+// A chunk on new pages fills them, free space in the heap is used
+// for a chunk when it is at least an eighth of that
+#define WMA__NURSERY_CHUNK_SIZE ((Wma_Word)WMA_NURSERY_CHUNK_PAGES * WMA_PAGE_SIZE - sizeof(Wma_Page_Chunk) - 2 * sizeof(Wma_Region))
+#define WMA__NURSERY_MIN_CHUNK  WMA__ALIGN(WMA__NURSERY_CHUNK_SIZE / 8)
+
+// 16 bytes of slack for aligning the first region and the size
+_Static_assert(sizeof(Wma_Nursery_Chunk) + sizeof(Wma_Region) + WMA_NURSERY_MAX_SIZE + 16 <= WMA__NURSERY_MIN_CHUNK,
+               "WMA_NURSERY_MAX_SIZE does not fit in WMA_NURSERY_CHUNK_PAGES");
+
+static int wma__is_nursery(Wma_Region* Region)
+{
+	return Region->prev == WMA__NURSERY_TAG;
+}
+
+// Where the first region goes, so that its payload is aligned
+static Wma_Word wma__nursery_start(Wma_Nursery_Chunk* Chunk)
+{
+	return WMA__ALIGN((Wma_Word)(Chunk + 1) + sizeof(Wma_Region)) - sizeof(Wma_Region);
+}
+
+// Payload size of a region holding `Size` bytes
+static Wma_Word wma__nursery_size(size_t Size)
+{
+	return WMA__ALIGN(sizeof(Wma_Region) + Size) - sizeof(Wma_Region);
+}
+
+// Hand a chunk over to the heap: survivors become ordinary regions, the
+// chunk header, dead allocations and the space never allocated become
+// free regions. The region holding the chunk starts the first free run.
+static void wma__nursery_retire(Wma_Generic_Allocator* Allocator, Wma_Nursery_Chunk* Chunk)
+{
+	Wma_Word    start = wma__nursery_start(Chunk);
+	Wma_Region* run   = (Wma_Region*)Chunk - 1; // Free run being gathered
+	Wma_Region* last  = run;
+	run->size = start - (Wma_Word)Chunk;
+
+	for (Wma_Word at = start; at < Chunk->top;)
+	{
+		Wma_Region* region = (void*)at;
+		at += sizeof(Wma_Region) + region->size;
+
+		if (region->used) {
+			region->prev = NULL;
+			region->next = NULL;
+			if (run) wma__generic_insert(Allocator, run);
+			run  = NULL;
+			last = region;
+		}
+		else if (run) {
+			run->size += sizeof(Wma_Region) + region->size;
+		}
+		else {
+			run  = region;
+			last = region;
+		}
+	}
+
+	// Space never allocated joins the last region when it cannot be a region itself
+	Wma_Word rest = Chunk->end - Chunk->top;
+	if (run || rest < sizeof(Wma_Region)) {
+		last->size += rest;
+	}
+	else {
+		run = (void*)Chunk->top;
+		run->size = rest - sizeof(Wma_Region);
+	}
+	if (run) wma__generic_insert(Allocator, run);
+}
+
+// The spare chunk, or a new one from the heap
+static Wma_Nursery_Chunk* wma__nursery_take(Wma_Generic_Allocator* Allocator)
+{
+	Wma_Nursery_Chunk* chunk = Allocator->nursery_spare;
+	Allocator->nursery_spare = NULL;
+	if (chunk)
+		return chunk;
+
+	// Small buckets too: the first region of a retired chunk is small
+	// until it is combined with the free space after it
+	void* ptr = WMA_INVALID;
+	for (int i = 0; i < WMA__BUCKET_COUNT && ptr == WMA_INVALID; ++i)
+	{
+		Wma_Region* region = Allocator->heads[i];
+		if (region == NULL)
+			continue;
+		wma__combine_regions(Allocator, region);
+		if (region->size >= WMA__NURSERY_MIN_CHUNK)
+			ptr = wma__generic_try_allocate(Allocator, i, region, wma__min(region->size, WMA__NURSERY_CHUNK_SIZE));
+	}
+	if (ptr == WMA_INVALID)
+		ptr = wma__generic_alloc(Allocator, WMA__NURSERY_CHUNK_SIZE);
+
+	Wma_Region* holder = (Wma_Region*)ptr - 1;
+	holder->prev = WMA__NURSERY_CHUNK_TAG;
+	chunk = ptr;
+	chunk->end = (Wma_Word)ptr + holder->size;
+	return chunk;
+}
+
+// The current chunk is full, move it to the full list and pick the next one
+static Wma_Nursery_Chunk* wma__nursery_next(Wma_Generic_Allocator* Allocator)
+{
+	uint32_t clock = Allocator->nursery_clock;
+
+	// The current chunk always has live allocations here,
+	// an empty one would have started over instead of filling up
+	Wma_Nursery_Chunk* full = Allocator->nursery;
+	if (full) {
+		full->full_at = clock;
+		full->prev    = Allocator->nursery_last;
+		full->next    = NULL;
+		if (Allocator->nursery_last) {
+			Allocator->nursery_last->next = full;
+		}
+		else {
+			Allocator->nursery_full = full;
+		}
+		Allocator->nursery_last = full;
+	}
 
-	if (Allocator->heads[bucket_index] == NULL) {
-		Allocator->heads[bucket_index] = region;
-		Allocator->tails[bucket_index] = region;
+	// Retire the oldest chunks that outlived the age threshold
+	while (Allocator->nursery_full && clock - Allocator->nursery_full->full_at >= WMA_NURSERY_AGE)
+	{
+		Wma_Nursery_Chunk* chunk = Allocator->nursery_full;
+		Allocator->nursery_full = chunk->next;
+		if (Allocator->nursery_full) {
+			Allocator->nursery_full->prev = NULL;
+		}
+		else {
+			Allocator->nursery_last = NULL;
+		}
+		wma__nursery_retire(Allocator, chunk);
+	}
+
+	Wma_Nursery_Chunk* next = wma__nursery_take(Allocator);
+	next->next = NULL;
+	next->prev = NULL;
+	next->top  = wma__nursery_start(next);
+	next->live = 0;
+	Allocator->nursery = next;
+	return next;
+}
+
+static void* wma__nursery_alloc(Wma_Generic_Allocator* Allocator, size_t Size)
+{
+	Wma_Word size = wma__nursery_size(Size);
+
+	Wma_Nursery_Chunk* chunk = Allocator->nursery;
+	if (chunk == NULL || chunk->top + sizeof(Wma_Region) + size > chunk->end) {
+		chunk = wma__nursery_next(Allocator);
+	}
+
+	Wma_Region* region = (void*)chunk->top;
+	*region = (Wma_Region) {
+		.size = size,
+		.used = 1,
+		.prev = WMA__NURSERY_TAG,
+		.next = (void*)chunk,
+	};
+	chunk->top  += sizeof(Wma_Region) + size;
+	chunk->live += 1;
+	Allocator->nursery_clock += 1;
+	return region + 1;
+}
+
+// A full chunk is empty, keep it as the spare or give it back to the heap
+static void wma__nursery_drop(Wma_Generic_Allocator* Allocator, Wma_Nursery_Chunk* Chunk)
+{
+	if (Chunk->prev) {
+		Chunk->prev->next = Chunk->next;
 	}
 	else {
-		Wma_Region* last = Allocator->tails[bucket_index];
-		region->prev = last;
-		last->next = region;
-		Allocator->tails[bucket_index] = region;
+		Allocator->nursery_full = Chunk->next;
+	}
+	if (Chunk->next) {
+		Chunk->next->prev = Chunk->prev;
+	}
+	else {
+		Allocator->nursery_last = Chunk->prev;
 	}
 
-    return wma__generic_try_allocate(Allocator, bucket_index, region, Size);
+	if (Allocator->nursery_spare == NULL) {
+		Chunk->top = wma__nursery_start(Chunk);
+		Allocator->nursery_spare = Chunk;
+	}
+	else {
+		wma__generic_insert(Allocator, (Wma_Region*)Chunk - 1);
+	}
 }
 
-static void* wma__generic_try_extend(Wma_Generic_Allocator* Allocator, uint32_t Bucket_Index, Wma_Region* Region)
+static void wma__nursery_free(Wma_Generic_Allocator* Allocator, Wma_Region* Region)
 {
-	return WMA_INVALID;
+	Wma_Nursery_Chunk* chunk = (void*)Region->next;
+	Region->used = 0;
+
+	// The last allocation can be taken back right away
+	if ((Wma_Word)(Region + 1) + Region->size == chunk->top) {
+		chunk->top = (Wma_Word)Region;
+	}
+
+	if (--chunk->live)
+		return;
+
+	if (chunk == Allocator->nursery) {
+		chunk->top = wma__nursery_start(chunk);
+	}
+	else {
+		wma__nursery_drop(Allocator, chunk);
+	}
+}
+
+// Only the last allocation of the current chunk can grow
+static int wma__nursery_try_extend(Wma_Generic_Allocator* Allocator, Wma_Region* Region, size_t Size)
+{
+	if (Size <= Region->size)
+		return 1;
+
+	Wma_Nursery_Chunk* chunk = (void*)Region->next;
+	Wma_Word end  = (Wma_Word)(Region + 1) + Region->size;
+	Wma_Word size = wma__nursery_size(Size);
+
+	if (chunk != Allocator->nursery || end != chunk->top)              return 0;
+	if (Size > WMA_NURSERY_MAX_SIZE)                                   return 0;
+	if ((Wma_Word)(Region + 1) + size > chunk->end)                    return 0;
+
+	chunk->top   = (Wma_Word)(Region + 1) + size;
+	Region->size = size;
+	return 1;
+}
+
+#endif
+
+WMA_DEF void* wma_generic_alloc(Wma_Generic_Allocator* Allocator, size_t Size)
+{
+#if defined(WMA_GENERIC_NURSERY)
+	if (Size <= WMA_NURSERY_MAX_SIZE)
+		return wma__nursery_alloc(Allocator, Size);
+#endif
+	return wma__generic_alloc(Allocator, Size);
+}
+
+// Grow `Region` into the free region right after it
+static int wma__generic_try_extend(Wma_Generic_Allocator* Allocator, Wma_Region* Region, size_t Size)
+{
+	if (Size <= Region->size)
+		return 1;
+
+	Size = WMA__ALIGN(Size);
+
+	Wma_Region* next = (void*)((Wma_Word)(Region + 1) + Region->size);
+	if (next->used)
+		return 0;
+
+	Wma_Word available = Region->size + sizeof(Wma_Region) + next->size;
+	if (available < Size)
+		return 0;
+
+	// `next` may be overwritten below, so take what we need from it first
+	Wma_Region* prev  = next->prev;
+	Wma_Region* after = next->next;
+	int list_index = (prev && after) ? -1 : wma__generic_list_index(Allocator, next);
+	if (!(prev && after) && list_index < 0)
+		return 0;
+
+	// Whatever is left over takes the place of `next` in its list
+	Wma_Region* rest = NULL;
+	if (available > Size + sizeof(Wma_Region)) {
+		rest = (void*)((Wma_Word)(Region + 1) + Size);
+		rest->size = available - Size - sizeof(Wma_Region);
+		rest->used = 0;
+		rest->prev = prev;
+		rest->next = after;
+		Region->size = Size;
+	}
+	else {
+		Region->size = available;
+	}
+
+	if (prev) {
+		prev->next = rest ? rest : after;
+	}
+	else {
+		Allocator->heads[list_index] = rest ? rest : after;
+	}
+	if (after) {
+		after->prev = rest ? rest : prev;
+	}
+	else {
+		Allocator->tails[list_index] = rest ? rest : prev;
+	}
+	return 1;
+}
+
+WMA_DEF size_t wma_generic_usable_size(Wma_Generic_Allocator* Allocator, void* Ptr)
+{
+	(void)Allocator;
+	Wma_Region* region = (void*)((Wma_Word)Ptr - sizeof(Wma_Region));
+	wma__assert(region->used == 1);
+	return region->size;
+}
+
+WMA_DEF int wma_generic_try_expand(Wma_Generic_Allocator* Allocator, void* Ptr, size_t Size)
+{
+	Wma_Region* region = (void*)((Wma_Word)Ptr - sizeof(Wma_Region));
+	wma__assert(region->used == 1);
+#if defined(WMA_GENERIC_NURSERY)
+	if (wma__is_nursery(region))
+		return wma__nursery_try_extend(Allocator, region, Size);
+#endif
+	return wma__generic_try_extend(Allocator, region, Size);
 }
 
 WMA_DEF void* wma_generic_realloc(Wma_Generic_Allocator* Allocator, void* Ptr, size_t Size)
@@ -512,93 +1630,496 @@ WMA_DEF void* wma_generic_realloc(Wma_Generic_Allocator* Allocator, void* Ptr, s
 	if (Ptr == NULL)
 		return wma_generic_alloc(Allocator, Size);
 
-	Wma_Region* region = (void*)((uint32_t)Ptr - sizeof(Wma_Region));
+	Wma_Region* region = (void*)((Wma_Word)Ptr - sizeof(Wma_Region));
     wma__assert(region->used == 1);
-	int bucket_index = wma__bucket_index(wma__max(region->size, 8));
-	uint32_t old_size = region->size;
+	Wma_Word old_size = region->size;
 
-	if (Size < region->size) {
-		// too easy xD
+	if (wma_generic_try_expand(Allocator, Ptr, Size))
 		return Ptr;
-	}
-
-	if (Size > region->size) {
-		void* ptr = wma__generic_try_extend(Allocator, bucket_index, region);
-		if (ptr != WMA_INVALID)
-			return ptr;
-	}
 
-	wma_generic_free(Allocator, Ptr);
+	// Allocating can retire the chunk of a nursery allocation,
+	// which is why the free looks at the region again afterwards
 	void* ptr = wma_generic_alloc(Allocator, Size);
 	wma__memory_copy(ptr, Ptr, old_size);
+	wma_generic_free(Allocator, Ptr);
 	return ptr;
 }
 
-static void wma__combine_regions(Wma_Generic_Allocator* Allocator, uint32_t Bucket_Index, Wma_Region* Region)
+WMA_DEF void wma_generic_free(Wma_Generic_Allocator* Allocator, void* Ptr)
+{
+	Wma_Region* region = (void*)((Wma_Word)Ptr - sizeof(Wma_Region));
+    wma__assert(region->used == 1);
+#if defined(WMA_GENERIC_NURSERY)
+	if (wma__is_nursery(region)) {
+		wma__nursery_free(Allocator, region);
+		return;
+	}
+#endif
+	wma__generic_insert(Allocator, region);
+}
+
+// Heap Implementation:
+// A heap owns every page its allocator takes, so resetting only
+// has to give back the pages, no matter how many allocations are
+// live. Pages reserved up front are kept by a reset.
+
+WMA_DEF void wma_heap_create(Wma_Heap* out_Heap, Wma_Heap_Kind Kind, uint32_t Initial_Pages)
 {
-	if (Region->prev && wma__regions_are_adjacent(Region->prev, Region)) {
-		Region->prev->size += Region->size + sizeof(Wma_Region);
-		Region->prev->next = Region->next;
-		Region->next->prev = Region->prev;
-		if (!Region->next) {
-			Allocator->tails[Bucket_Index] = Region->prev;
+	wma__assert(out_Heap != NULL);
+
+	*out_Heap = (Wma_Heap) {
+		.kind          = Kind,
+		.initial_pages = Initial_Pages,
+	};
+
+	switch (Kind)
+	{
+	case WMA_HEAP_FAST: {
+		wma_fast_allocator_create(&out_Heap->fast, WMA_FAST_MAX_ALLOCATIONS, Initial_Pages);
+		break;
+	}
+	case WMA_HEAP_GENERIC: {
+		if (Initial_Pages == 0)
+			break;
+		out_Heap->generic.base       = wma__pages_acquire(0, Initial_Pages);
+		out_Heap->generic.base_pages = Initial_Pages;
+		break;
+	}
+	}
+}
+
+WMA_DEF void wma_heap_reset(Wma_Heap* Heap)
+{
+	switch (Heap->kind)
+	{
+	case WMA_HEAP_FAST: {
+		Wma_Fast_Allocator* allocator = &Heap->fast;
+
+		// Keep the oldest chunk (the initial heap), give back the rest
+		Wma_Page_Chunk* base = allocator->chunks;
+		while (base->next) {
+			Wma_Page_Chunk* next = base->next;
+			wma__pages_release((Wma_Word)base, base->page_count);
+			base = next;
+		}
+
+		// Give back pages that were grown in place past the initial heap
+		uint32_t base_pages = wma__max(Heap->initial_pages, 1);
+		if (base->page_count > base_pages) {
+			wma__pages_release((Wma_Word)base + base_pages * WMA_PAGE_SIZE, base->page_count - base_pages);
+			base->page_count = base_pages;
 		}
-		Region = Region->prev; // prev now replaces this region
+
+		// The slot table keeps its size
+		Wma_Page_Chunk* table = (void*)allocator->start;
+		allocator->chunks         = base;
+		allocator->total_size     = (table->page_count + base_pages) * WMA_PAGE_SIZE;
+		allocator->available_size = base_pages * WMA_PAGE_SIZE - sizeof(Wma_Page_Chunk);
+		wma_fast_allocator_reset(allocator);
+		break;
 	}
-	
-	if (Region->next && wma__regions_are_adjacent(Region, Region->next)) {
-		Region->size += Region->next->size + sizeof(Wma_Region);
-		if (Region->next->next) {
-			Region->next->next->prev = Region;
+	case WMA_HEAP_GENERIC: {
+		Wma_Generic_Allocator* allocator = &Heap->generic;
+		wma__chunks_release(allocator->chunks);
+
+		*allocator = (Wma_Generic_Allocator) {
+			.base       = allocator->base,
+			.base_pages = allocator->base_pages,
+		};
+		break;
+	}
+	}
+}
+
+WMA_DEF void wma_heap_destroy(Wma_Heap* Heap)
+{
+	switch (Heap->kind)
+	{
+	case WMA_HEAP_FAST: {
+		wma__chunks_release(Heap->fast.chunks);
+		wma__chunks_release((Wma_Page_Chunk*)Heap->fast.start);
+		break;
+	}
+	case WMA_HEAP_GENERIC: {
+		wma__chunks_release(Heap->generic.chunks);
+		if (Heap->generic.base_pages) {
+			wma__pages_release(Heap->generic.base, Heap->generic.base_pages);
 		}
-		else {
-			Allocator->tails[Bucket_Index] = Region;
+		break;
+	}
+	}
+
+	*Heap = (Wma_Heap) { .kind = WMA__HEAP_DESTROYED };
+}
+
+WMA_DEF void* wma_heap_realloc(Wma_Heap* Heap, void* Ptr, size_t Size)
+{
+	switch (Heap->kind)
+	{
+	case WMA_HEAP_FAST:    return wma_fast_realloc(&Heap->fast, Ptr, Size);
+	case WMA_HEAP_GENERIC: return wma_generic_realloc(&Heap->generic, Ptr, Size);
+	}
+	return NULL;
+}
+
+WMA_DEF void* wma_heap_alloc(Wma_Heap* Heap, size_t Size)
+{
+	switch (Heap->kind)
+	{
+	case WMA_HEAP_FAST:    return wma_fast_alloc(&Heap->fast, Size);
+	case WMA_HEAP_GENERIC: return wma_generic_alloc(&Heap->generic, Size);
+	}
+	return NULL;
+}
+
+WMA_DEF void wma_heap_free(Wma_Heap* Heap, void* Ptr)
+{
+	switch (Heap->kind)
+	{
+	case WMA_HEAP_FAST:    wma_fast_free(&Heap->fast, Ptr);       break;
+	case WMA_HEAP_GENERIC: wma_generic_free(&Heap->generic, Ptr); break;
+	}
+}
+
+WMA_DEF size_t wma_heap_usable_size(Wma_Heap* Heap, void* Ptr)
+{
+	switch (Heap->kind)
+	{
+	case WMA_HEAP_FAST:    return wma_fast_usable_size(&Heap->fast, Ptr);
+	case WMA_HEAP_GENERIC: return wma_generic_usable_size(&Heap->generic, Ptr);
+	}
+	return 0;
+}
+
+WMA_DEF int wma_heap_try_expand(Wma_Heap* Heap, void* Ptr, size_t Size)
+{
+	switch (Heap->kind)
+	{
+	case WMA_HEAP_FAST:    return wma_fast_try_expand(&Heap->fast, Ptr, Size);
+	case WMA_HEAP_GENERIC: return wma_generic_try_expand(&Heap->generic, Ptr, Size);
+	}
+	return 0;
+}
+
+// Snapshot Implementation:
+// An image is a header (with a copy of the heap structure), the page
+// ranges the heap owns, then the byte ranges that hold live data.
+// Pointers stay valid because everything is restored to the same address.
+// The image is built twice, once to measure it and once to write it.
+
+#define WMA__SNAPSHOT_MAGIC 0x53414D57 // "WMAS"
+
+#if defined(WMA_FAST_SIMD)
+#define WMA__SNAPSHOT_SIMD 1
+#else
+#define WMA__SNAPSHOT_SIMD 0
+#endif
+
+#if defined(WMA_GENERIC_NURSERY)
+#define WMA__SNAPSHOT_NURSERY 2
+#else
+#define WMA__SNAPSHOT_NURSERY 0
+#endif
+
+#define WMA__SNAPSHOT_FLAGS (WMA__SNAPSHOT_SIMD | WMA__SNAPSHOT_NURSERY)
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t flags;            // Build options that change the heap layout
+	uint32_t heap_size;        // sizeof(Wma_Heap)
+	Wma_Word memory_pages;     // Memory size when the snapshot was taken
+	uint32_t page_range_count;
+	uint32_t data_range_count;
+	Wma_Heap heap;
+} Wma__Snapshot_Header;
+
+typedef struct {
+	Wma_Word start;
+	Wma_Word size;             // In pages for page ranges, bytes for data ranges
+} Wma__Snapshot_Range;
+
+typedef struct {
+	uint8_t* at;               // NULL when only measuring
+	size_t   size;
+	uint32_t page_range_count;
+	uint32_t data_range_count;
+} Wma__Snapshot_Writer;
+
+// Everything in an image starts at a multiple of the word size,
+// so the ranges can be read in place
+static Wma_Word wma__snapshot_pad(Wma_Word Size)
+{
+	return (Size + sizeof(Wma_Word) - 1) & ~(Wma_Word)(sizeof(Wma_Word) - 1);
+}
+
+static void wma__snapshot_write(Wma__Snapshot_Writer* Writer, const void* Data, Wma_Word Size)
+{
+	if (Writer->at) {
+		wma__memory_copy(Writer->at + Writer->size, (void*)Data, Size);
+	}
+	Writer->size += wma__snapshot_pad(Size);
+}
+
+static void wma__snapshot_pages(Wma__Snapshot_Writer* Writer, Wma_Word Start, uint32_t Page_Count)
+{
+	Wma__Snapshot_Range range = { Start, Page_Count };
+	wma__snapshot_write(Writer, &range, sizeof(range));
+	Writer->page_range_count += 1;
+}
+
+static void wma__snapshot_data(Wma__Snapshot_Writer* Writer, Wma_Word Start, Wma_Word Size)
+{
+	Wma__Snapshot_Range range = { Start, Size };
+	wma__snapshot_write(Writer, &range, sizeof(range));
+	wma__snapshot_write(Writer, (void*)Start, Size);
+	Writer->data_range_count += 1;
+}
+
+static void wma__snapshot_fast(Wma__Snapshot_Writer* Writer, Wma_Fast_Allocator* Allocator)
+{
+	Wma_Page_Chunk* table = (void*)Allocator->start;
+	wma__snapshot_pages(Writer, (Wma_Word)table, table->page_count);
+	for (Wma_Page_Chunk* chunk = Allocator->chunks; chunk; chunk = chunk->next)
+		wma__snapshot_pages(Writer, (Wma_Word)chunk, chunk->page_count);
+
+	// Chunk headers, and the part of the slot table in use
+	for (Wma_Page_Chunk* chunk = Allocator->chunks; chunk; chunk = chunk->next)
+		wma__snapshot_data(Writer, (Wma_Word)chunk, sizeof(Wma_Page_Chunk));
+#if defined(WMA_FAST_SIMD)
+	wma__snapshot_data(Writer, Allocator->start, sizeof(Wma_Page_Chunk) + Allocator->slot_count * sizeof(Wma_Word));
+	wma__snapshot_data(Writer, (Wma_Word)Allocator->sizes, Allocator->slot_count * sizeof(Wma_Word));
+#else
+	wma__snapshot_data(Writer, Allocator->start, sizeof(Wma_Page_Chunk) + Allocator->slot_count * sizeof(Wma_Slot));
+#endif
+
+	// Runs of allocated slots, except the ones covering the hole before
+	// a chunk (they end where the chunk starts). Chunks are taken above
+	// the heap, so going from the top down passes them newest first.
+	Wma_Page_Chunk* chunk = Allocator->chunks;
+	Wma_Word run_start = 0;
+	Wma_Word run_size  = 0;
+	for (uint32_t i = Allocator->slot_count; i-- > 0;)
+	{
+		Wma_Slot slot = wma__get_slot(Allocator, i);
+		Wma_Word end = Allocator->heap_start + slot.offset + slot.size;
+		while (chunk && (Wma_Word)(chunk + 1) > end)
+			chunk = chunk->next;
+
+		int is_hole = chunk && (Wma_Word)(chunk + 1) == end;
+		if (slot.allocated && !is_hole) {
+			run_start = slot.offset;
+			run_size += slot.size;
+			continue;
+		}
+		if (run_size) {
+			wma__snapshot_data(Writer, Allocator->heap_start + run_start, run_size);
+			run_size = 0;
 		}
-		Region->next = Region->next->next;
+	}
+	if (run_size) {
+		wma__snapshot_data(Writer, Allocator->heap_start + run_start, run_size);
 	}
 }
 
-WMA_DEF void wma_generic_free(Wma_Generic_Allocator* Allocator, void* Ptr)
+// Regions in [Start, End) follow each other back to back, sentinels included.
+// Every header is saved (free ones hold the bucket links), payloads only when used,
+// and nursery chunks only up to their top.
+static void wma__snapshot_regions(Wma__Snapshot_Writer* Writer, Wma_Word Start, Wma_Word End)
 {
-	Wma_Region* region = (void*)((uint32_t)Ptr - sizeof(Wma_Region));
-    wma__assert(region->used == 1);
-	int bucket_index = wma__bucket_index(wma__max(region->size, 8));
+	Wma_Word run_start = Start;
+	Wma_Word run_end   = Start;
+	for (Wma_Word at = Start; at < End;)
+	{
+		Wma_Region* region = (void*)at;
+		Wma_Word next = at + sizeof(Wma_Region) + region->size;
+		if (at != run_end) {
+			wma__snapshot_data(Writer, run_start, run_end - run_start);
+			run_start = at;
+		}
+		run_end = region->used ? next : at + sizeof(Wma_Region);
+#if defined(WMA_GENERIC_NURSERY)
+		if (region->prev == WMA__NURSERY_CHUNK_TAG)
+			run_end = ((Wma_Nursery_Chunk*)(region + 1))->top;
+#endif
+		at = next;
+	}
+	if (run_end != run_start) {
+		wma__snapshot_data(Writer, run_start, run_end - run_start);
+	}
+}
 
-	region->used = 0;
+static void wma__snapshot_generic(Wma__Snapshot_Writer* Writer, Wma_Generic_Allocator* Allocator)
+{
+	if (Allocator->base_pages) {
+		wma__snapshot_pages(Writer, Allocator->base, Allocator->base_pages);
+	}
+	for (Wma_Page_Chunk* chunk = Allocator->chunks; chunk; chunk = chunk->next)
+		wma__snapshot_pages(Writer, (Wma_Word)chunk, chunk->page_count);
 
-	Wma_Region* left = region->prev;
-	while (left)
+	if (Allocator->base_used) {
+		wma__snapshot_regions(Writer, Allocator->base, Allocator->base + Allocator->base_used * WMA_PAGE_SIZE);
+	}
+	for (Wma_Page_Chunk* chunk = Allocator->chunks; chunk; chunk = chunk->next)
 	{
-		if (left->used == 0) break;
-		left->next = region;
-		left = left->prev;
+		wma__snapshot_data(Writer, (Wma_Word)chunk, sizeof(Wma_Page_Chunk));
+		wma__snapshot_regions(Writer, (Wma_Word)(chunk + 1), (Wma_Word)chunk + chunk->page_count * WMA_PAGE_SIZE);
 	}
-	
-	Wma_Region* right = region->next;
-	while (right)
+}
+
+static void wma__snapshot_heap(Wma__Snapshot_Writer* Writer, Wma_Heap* Heap)
+{
+	Wma__Snapshot_Header header = {
+		.magic            = WMA__SNAPSHOT_MAGIC,
+		.version          = WMA_SNAPSHOT_VERSION,
+		.flags            = WMA__SNAPSHOT_FLAGS,
+		.heap_size        = sizeof(Wma_Heap),
+		.memory_pages     = wma__memory_size(),
+		.page_range_count = Writer->page_range_count,
+		.data_range_count = Writer->data_range_count,
+		.heap             = *Heap,
+	};
+	Writer->page_range_count = 0;
+	Writer->data_range_count = 0;
+	wma__snapshot_write(Writer, &header, sizeof(header));
+
+	switch (Heap->kind)
 	{
-		if (right->used == 0) break;
-		right->prev = region;
-		right = right->next;
+	case WMA_HEAP_FAST:    wma__snapshot_fast(Writer, &Heap->fast);       break;
+	case WMA_HEAP_GENERIC: wma__snapshot_generic(Writer, &Heap->generic); break;
 	}
+}
+
+WMA_DEF size_t wma_snapshot(Wma_Heap* Heap, void* Buffer, size_t Buffer_Size)
+{
+	Wma__Snapshot_Writer writer = {0};
+	wma__snapshot_heap(&writer, Heap);
 
-	region->prev = left;
-	region->next = right;
+	if (Buffer == NULL || Buffer_Size < writer.size)
+		return writer.size;
+
+	writer.at   = Buffer;
+	writer.size = 0;
+	wma__snapshot_heap(&writer, Heap);
+	return writer.size;
+}
 
-	if (left) {
-		left->next = region;
+// Take exactly the pages [Address, Address + Page_Count) out of the page pool
+static int wma__pages_claim(Wma_Word Address, uint32_t Page_Count)
+{
+	Wma_Word end = Address + Page_Count * WMA_PAGE_SIZE;
+	for (Wma_Page_Chunk** link = &wma__page_pool; *link; link = &(*link)->next)
+	{
+		Wma_Page_Chunk* chunk = *link;
+		Wma_Word chunk_start = (Wma_Word)chunk;
+		Wma_Word chunk_end   = chunk_start + chunk->page_count * WMA_PAGE_SIZE;
+
+		if (chunk_end <= Address) continue;
+		if (chunk_start > Address || chunk_end < end) return 0;
+
+		if (chunk_end > end) {
+			Wma_Page_Chunk* rest = (void*)end;
+			rest->next       = chunk->next;
+			rest->page_count = (chunk_end - end) / WMA_PAGE_SIZE;
+			chunk->next = rest;
+		}
+		if (chunk_start < Address) {
+			chunk->page_count = (Address - chunk_start) / WMA_PAGE_SIZE;
+		}
+		else {
+			*link = chunk->next;
+		}
+		return 1;
 	}
-	else {
-		Allocator->heads[bucket_index] = region;
+	return 0;
+}
+
+// Walk the whole image before touching memory: every range has to fit
+// in the image, and every data range has to land inside a page range.
+static int wma__snapshot_check(const Wma__Snapshot_Header* Header, size_t Image_Size)
+{
+	Wma_Word left = Image_Size - sizeof(*Header);
+	if (Header->page_range_count > left / sizeof(Wma__Snapshot_Range))
+		return 0;
+	left -= Header->page_range_count * sizeof(Wma__Snapshot_Range);
+
+	const Wma__Snapshot_Range* pages = (const void*)(Header + 1);
+	for (uint32_t i = 0; i < Header->page_range_count; ++i)
+	{
+		Wma_Word first_page = pages[i].start / WMA_PAGE_SIZE;
+		if (pages[i].start % WMA_PAGE_SIZE)                               return 0;
+		if (pages[i].size == 0)                                           return 0;
+		if (first_page > Header->memory_pages)                            return 0;
+		if (pages[i].size > Header->memory_pages - first_page)            return 0;
 	}
-	if (right) {
-		right->prev = region;
+
+	const uint8_t* at = (const void*)(pages + Header->page_range_count);
+	for (uint32_t i = 0; i < Header->data_range_count; ++i)
+	{
+		const Wma__Snapshot_Range* range = (const void*)at;
+		if (left < sizeof(*range))
+			return 0;
+		left -= sizeof(*range);
+		if (range->size > left || wma__snapshot_pad(range->size) > left)
+			return 0;
+		left -= wma__snapshot_pad(range->size);
+
+		int inside = 0;
+		for (uint32_t k = 0; k < Header->page_range_count && !inside; ++k)
+		{
+			Wma_Word end = pages[k].start + pages[k].size * WMA_PAGE_SIZE;
+			inside = range->start >= pages[k].start && range->start <= end && range->size <= end - range->start;
+		}
+		if (!inside)
+			return 0;
+
+		at += sizeof(*range) + wma__snapshot_pad(range->size);
 	}
-	else {
-		Allocator->tails[bucket_index] = region;
+	return 1;
+}
+
+WMA_DEF int wma_restore(Wma_Heap* out_Heap, const void* Image, size_t Image_Size)
+{
+	const Wma__Snapshot_Header* header = Image;
+	if (Image_Size < sizeof(*header))                return 0;
+	if (header->magic     != WMA__SNAPSHOT_MAGIC)    return 0;
+	if (header->version   != WMA_SNAPSHOT_VERSION)   return 0;
+	if (header->flags     != WMA__SNAPSHOT_FLAGS)    return 0;
+	if (header->heap_size != sizeof(Wma_Heap))       return 0;
+	if (!wma__snapshot_check(header, Image_Size))    return 0;
+
+	// Grow to the recorded size, new pages go to the pool until claimed
+	wma__page_pool_seed();
+	Wma_Word memory_pages = wma__memory_size();
+	if (memory_pages < header->memory_pages) {
+		Wma_Word grow_pages = header->memory_pages - memory_pages;
+		if (wma__memory_grow(grow_pages) == (Wma_Word)-1)
+			return 0;
+		wma__pages_release(memory_pages * WMA_PAGE_SIZE, grow_pages);
+	}
+
+	const Wma__Snapshot_Range* pages = (const void*)(header + 1);
+	for (uint32_t i = 0; i < header->page_range_count; ++i)
+	{
+		if (wma__pages_claim(pages[i].start, pages[i].size))
+			continue;
+
+		// Pages are in use by someone else, undo
+		for (uint32_t k = 0; k < i; ++k)
+			wma__pages_release(pages[k].start, pages[k].size);
+		return 0;
 	}
 
-	wma__combine_regions(Allocator, bucket_index, region);
+	const uint8_t* at = (const void*)(pages + header->page_range_count);
+	for (uint32_t i = 0; i < header->data_range_count; ++i)
+	{
+		const Wma__Snapshot_Range* range = (const void*)at;
+		wma__memory_copy((void*)range->start, (void*)(range + 1), range->size);
+		at += sizeof(*range) + wma__snapshot_pad(range->size);
+	}
+
+	*out_Heap = header->heap;
+	return 1;
 }
 
 #endif
@@ -622,6 +2143,26 @@ WMA_DEF void wma_generic_free(Wma_Generic_Allocator* Allocator, void* Ptr)
 //     - generic: need to implement memory shrinking with realloc
 //	   - generic: need to implement memory extension with realloc
 //
+// version 1.2.0 (2026.10.18)
+//     - Added heap instances (wma_heap_*), with reset and destroy
+//     - Pages are taken from a shared page pool, released pages get reused
+//     - fast: works alongside other users of `memory_grow`
+//     - Added wma_usable_size and wma_try_expand
+//     - generic: memory extension with realloc
+//     - generic: fix free corrupting the bucket lists, freed regions
+//       merge with the free regions after them, allocations also look
+//       at larger buckets before growing
+//     - fast: WMA_FAST_SIMD option, slot table as arrays with SIMD search
+//     - Added wma_snapshot and wma_restore for heaps
+//     - Memory above `__heap_base` is used before growing, the partial
+//       page right above it goes to the global generic allocator
+//     - fast: slot table starts at one page and grows when full
+//     - Addresses and sizes are pointer sized, so wasm64 (memory64) works
+//     - Added WMA_HOST option to run on native memory, past 4GB on 64-bit
+//     - generic: WMA_GENERIC_NURSERY option, bump allocates short-lived
+//       small allocations from chunks carved out of the heap, old chunks
+//       are retired into free regions and ordinary allocations
+//
 // Roadmap (no plans for when):
 //     - Measure performance
 //     - Implement memory arenas!!